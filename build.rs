@@ -13,6 +13,7 @@ fn main() {
         "p4source/script",
         "p4source/map",
         "p4source/zlib",
+        "p4source/lz4",
         "src",
     ];
 
@@ -51,6 +52,7 @@ fn main() {
         .include("p4source/script")
         .include("p4source/map")
         .include("p4source/zlib")
+        .include("p4source/lz4")
         .file("p4source/client/client.cc")
         .file("p4source/client/clientapi.cc")
         .file("p4source/client/clientaltsynchandler.cc")
@@ -67,25 +69,30 @@ fn main() {
         .file("p4source/client/clientresolvea.cc")
         .file("p4source/client/clientservice.cc")
         .file("p4source/client/clientservicer.cc")
+        .file("p4source/client/clienttraverse.cc")
         .file("p4source/client/clienttrust.cc")
         .file("p4source/client/clientuser.cc")
         .file("p4source/client/clientusercolor.cc")
         .file("p4source/client/clientuserdbg.cc")
         .file("p4source/client/clientusermsh.cc")
         .file("p4source/client/clientusernull.cc")
+        .file("p4source/client/clientwriter.cc")
         .file("p4source/client/p4libs.cc")
         .file("p4source/client/serverhelper.cc")
         .file("p4source/client/serverhelperapi.cc")
+        .file("p4source/client/statbatch.cc")
         .file("p4source/diff/diff.cc")
         .file("p4source/diff/diffan.cc")
         .file("p4source/diff/diffflags.cc")
         .file("p4source/diff/diffmerge.cc")
         .file("p4source/diff/diffmulti.cc")
         .file("p4source/diff/diffmultimulti.cc")
+        .file("p4source/diff/diffscan.cc")
         .file("p4source/diff/diffsp.cc")
         .file("p4source/diff/diffsr.cc")
         .file("p4source/i18n/charcvt.cc")
         .file("p4source/i18n/charman.cc")
+        .file("p4source/i18n/charscan.cc")
         .file("p4source/i18n/charset.cc")
         .file("p4source/i18n/charfold.cc")
         .file("p4source/i18n/basecvt.cc")
@@ -102,8 +109,10 @@ fn main() {
         .file("p4source/map/maphalf.cc")
         .file("p4source/map/mapitem.cc")
         .file("p4source/map/mapjoin.cc")
+        .file("p4source/map/mapsnap.cc")
         .file("p4source/map/mapstring.cc")
         .file("p4source/map/maptable.cc")
+        .file("p4source/map/maptrans.cc")
         .file("p4source/msgs/msgclient.cc")
         .file("p4source/msgs/msgconfig_wrap.cc")
         .file("p4source/msgs/msgdb.cc")
@@ -143,6 +152,7 @@ fn main() {
         .file("p4source/rpc/rpcmulti.cc")
         .file("p4source/rpc/rpcservice.cc")
         .file("p4source/rpc/rpctrans.cc")
+        .file("p4source/support/arena.cc")
         .file("p4source/support/base64.cc")
         .file("p4source/support/bitarray.cc")
         .file("p4source/support/contextpat.cc")
@@ -265,5 +275,6 @@ fn main() {
         .file("p4source/sys/zip.c")
         .file("p4source/sys/ioapi.c")
         .file("p4source/zlib/x86.c")// not sure why this is missing from local zlib
+        .file("p4source/lz4/lz4.c")
         .compile("ccode");
 }
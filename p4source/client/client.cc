@@ -25,6 +25,8 @@
 # include <enviro.h>
 # include <ignore.h>
 # include <filesys.h>
+# include <arena.h>
+# include <statbatch.h>
 
 # include <msgclient.h>
 # include <msgserver.h>
@@ -41,6 +43,7 @@
 # include "clientmerge.h"
 # include "clientscript.h"
 # include "client.h"
+# include "clientwriter.h"
 
 #include "clientaltsynchandler.h"
 
@@ -75,6 +78,9 @@ Client::Client( Enviro *e ) : Rpc( &service )
 	ownCwd = 1;
 	fstatPartial = 0;
 	extraVars = 0;
+	writer = 0;
+	arena = 0;
+	statBatch = 0;
 
 	protocolXfiles = -1;
 	protocolNocase = 0;
@@ -135,16 +141,25 @@ Client::Client( Enviro *e ) : Rpc( &service )
 
 Client::~Client()
 {
+	// Finish writing files before the translators go.
+
+	delete writer;
+
 	CleanupTrans();
 	delete gCharSetCvtCache;
 	if( ownEnviro )
 	    delete enviro;
 	delete fstatPartial;
+	delete statBatch;
 	delete ignore;
 	delete extraVars;
 	delete argv;
 	if( ownExts )
 	    delete exts;
+
+	// Handles still open keep their part of it.
+
+	delete arena;
 }
 
 void
@@ -171,6 +186,12 @@ Client::Init( Error *e )
 	    service.SetProtocol( P4Tag::v_chunking );
 # endif
 
+	// Offer the server a faster codec for link compression.
+
+	if( p4tunable.Get( P4TUNE_NET_COMPRESSION_CODEC ) )
+	    service.SetProtocol( P4Tag::v_linkCodec,
+				 p4tunable.Get( P4TUNE_NET_COMPRESSION_CODEC ) );
+
 	if( !e->Test() )
 	    service.SetEndpoint( GetPort().Text(), e );
 
@@ -422,6 +443,17 @@ Client::WaitTag( ClientUser *u )
 	    return;
 	}
 
+	// The transient objects of handling a command (ClientFile,
+	// FileSys, PathSys) come from the arena, which starts over as
+	// each command is released if they have all gone.
+
+	int arenaSize = p4tunable.Get( P4TUNE_RPC_CLIENT_ARENA );
+
+	if( !arena && arenaSize )
+	    arena = new Arena( arenaSize );
+
+	ArenaScope scope( arena );
+
 	// While any RunTag() requests are outstanding, Dispatch().
 	// Dispatch() returns exactly once for each Invoke().
 
@@ -429,6 +461,9 @@ Client::WaitTag( ClientUser *u )
 	{
 	    Dispatch();
 
+	    if( arena )
+		arena->Reset();
+
 	    authenticated = 1;
 
 	    // lowerTag is done; signal that
@@ -437,6 +472,14 @@ Client::WaitTag( ClientUser *u )
 
 	    ClientUser *ui = tags[ lowerTag ];
 
+	    // Deliver what's left of the fstat records.
+
+	    if( statBatch )
+	    {
+		FstatBatchFlush();
+		statBatch->Reset();
+	    }
+
 	    if( Dropped() && !IoError()->CheckId( MsgRpc::Break ) )
 		ui->Message( IoError() );
 
@@ -810,6 +853,44 @@ Client::FstatPartialClear()
 	fstatPartial = 0;
 }
 
+int
+Client::FstatBatchAppend( StrDict *part, int last )
+{
+	ClientUser *ui = tags[ lowerTag ];
+	int size = ui->OutputStatBatchSize();
+
+	if( size <= 0 )
+	    return 0;
+
+	if( !statBatch )
+	    statBatch = new StatBatch;
+
+	statBatch->Add( part );
+
+	if( !last )
+	    return 1;
+
+	statBatch->End();
+
+	if( statBatch->Count() >= size )
+	    FstatBatchFlush();
+
+	return 1;
+}
+
+void
+Client::FstatBatchFlush()
+{
+	// Called from GetUi(), so that records go out ahead of
+	// anything else the command outputs.
+
+	if( !statBatch->Count() )
+	    return;
+
+	tags[ lowerTag ]->OutputStatBatch( statBatch );
+	statBatch->Clear();
+}
+
 void
 Client::SetProtocol( const char *p, const char *v )
 {
@@ -122,6 +122,9 @@ class CharSetCvtCache;
 class Ignore;
 class Enviro;
 class StrBufDict;
+class ClientWriter;
+class Arena;
+class StatBatch;
 
 enum EnvVarType
 {
@@ -297,10 +300,16 @@ class Client : public Rpc {
 	const StrPtr *	GetEnviroFile();
 	Ignore*		GetIgnore() { return ignore; }
 	void		Confirm( const StrPtr *confirm );
-	ClientUser *	GetUi() { return tags[ lowerTag ]; }
+	ClientUser *	GetUi()
+			{
+			    if( statBatch ) FstatBatchFlush();
+			    return tags[ lowerTag ];
+			}
 	
 	void		FstatPartialAppend( StrDict *part );
 	void		FstatPartialClear();
+	int		FstatBatchAppend( StrDict *part, int last );
+	void		FstatBatchFlush();
 
 	void		SetError() { errors++; }
 	int		GetErrors() { return errors; }
@@ -311,6 +320,9 @@ class Client : public Rpc {
 	void		OutputError( Error *e );
 
 	Handlers	handles;
+	ClientWriter	*writer;	// write-behind, see clientwriter.h
+	Arena		*arena;		// for each command, see WaitTag()
+	StatBatch	*statBatch;	// for OutputStatBatch()
 
 	void		NewHandler();
 	CharSetCvt	*fromTransDialog, *toTransDialog;
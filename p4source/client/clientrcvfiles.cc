@@ -14,6 +14,8 @@
 # include <i18napi.h>
 # include <signaler.h>
 # include <p4libs.h>
+# include <debug.h>
+# include <tunable.h>
 
 # include <pathsys.h>
 # include <enviro.h>
@@ -23,19 +25,411 @@
 # include "clientprog.h"
 
 # ifdef HAS_CPP11
+# include <condition_variable>
+# include <deque>
 # include <future>
 # include <vector>
 # include <mutex>
 
+// Records queued for the master before the workers wait
+
+# define OUTPUT_QUEUE_MAX	1024
+
+// Records kept for reuse
+
+# define OUTPUT_SPARE	64
+
 class ThreadedKeepAlive : public KeepAlive {
     public:
 	int		IsAlive() { return !signaler.IsIntr(); }
 } ;
 
+static ThreadedKeepAlive threadedKeepAlive;
+
+/*
+ * TransferSetup - what a ThreadedTransfer's connections are made with
+ *
+ *	Read from the parent before the threads start: various parts
+ *	of the P4API are not thread-safe (a crash was seen in
+ *	client->GetPassword()).  The key names the settings, for
+ *	TransferPool.
+ */
+
+struct TransferSetup {
+	StrBuf		port;
+	StrBuf		user;
+	StrBuf		client;
+	StrBuf		password;
+	StrBuf		prog;
+	StrBuf		version;
+	int		trans;
+	KeepAlive	*keepAlive;
+	StrBufDict	pVars;
+
+	StrBuf		key;
+} ;
+
+/*
+ * TransferPool - connections of one ThreadedTransfer kept for the next
+ *
+ *	Kept as a handle on the parent Client, so that successive
+ *	parallel transfers reuse their connections (and the connect,
+ *	handshake and protocol exchange they cost).  Connections are
+ *	reused only with the same TransferSetup key, and are closed
+ *	if the server has dropped them.  After each transfer, at most
+ *	net.parallel.pool are kept.
+ */
+
+class TransferPool : public LastChance {
+
+    public:
+			~TransferPool() { Trim( 0 ); }
+
+	static TransferPool *
+			GetHandle( Client *client, Error *e );
+
+	Client		*Take();
+	void		Give( Client *c );
+	void		Trim( int keep );
+
+	StrBuf		key;
+
+    private:
+	std::mutex	mutex;
+	std::vector< Client * > idle;
+} ;
+
+TransferPool *
+TransferPool::GetHandle( Client *client, Error *e )
+{
+	const StrRef name( "transferPool" );
+
+	TransferPool *pool = (TransferPool *)client->handles.Get( &name, e );
+
+	if( pool )
+	    return pool;
+
+	e->Clear();
+
+	pool = new TransferPool;
+	client->handles.Install( &name, pool, e );
+
+	if( e->Test() )
+	{
+	    delete pool;
+	    pool = 0;
+	}
+
+	return pool;
+}
+
+Client *
+TransferPool::Take()
+{
+	std::lock_guard< std::mutex > lock( mutex );
+
+	while( !idle.empty() )
+	{
+	    Client *c = idle.back();
+	    idle.pop_back();
+
+	    // The server may have closed it while it sat idle.
+
+	    if( c->IsAlive() )
+		return c;
+
+	    Error e;
+	    c->Final( &e );
+	    delete c;
+	}
+
+	return 0;
+}
+
+void
+TransferPool::Give( Client *c )
+{
+	std::lock_guard< std::mutex > lock( mutex );
+
+	idle.push_back( c );
+}
+
+void
+TransferPool::Trim( int keep )
+{
+	std::lock_guard< std::mutex > lock( mutex );
+
+	while( (int)idle.size() > keep )
+	{
+	    Error e;
+	    Client *c = idle.back();
+	    idle.pop_back();
+
+	    c->Final( &e );
+	    delete c;
+	}
+}
+
+/*
+ * TransferOutput - the workers' output, on its way to the master
+ *
+ *	The workers queue a copy of each ClientUser callback and go
+ *	on, while the thread that called Transfer() delivers them to
+ *	the master ClientUser in the order queued (and so in order
+ *	for each worker).  A slow master thus holds up no worker, and
+ *	the master is only ever called from one thread.  The lock is
+ *	held to queue or take records, never across a callback.
+ *
+ *	At most OUTPUT_QUEUE_MAX records are queued: beyond that, the
+ *	workers wait for the master to catch up.  OutputStatPartial()
+ *	waits for its record to be delivered, for the master's answer.
+ *
+ *	Records (and the StrBufs of their copies) are recycled.  The
+ *	counts are reported with -vnet=2.
+ */
+
+enum TransferOutputType {
+	TO_HANDLEERROR,
+	TO_MESSAGE,
+	TO_OUTPUTERROR,
+	TO_OUTPUTINFO,
+	TO_OUTPUTBINARY,
+	TO_OUTPUTTEXT,
+	TO_OUTPUTSTAT,
+	TO_OUTPUTSTATPARTIAL
+} ;
+
+struct TransferRecord {
+	TransferOutputType type;
+	char		level;
+	StrBuf		data;
+	StrBufDict	dict;
+	Error		err;
+	int		result;
+	int		*delivered;	// set for OutputStatPartial()
+} ;
+
+class TransferOutput {
+
+    public:
+			TransferOutput();
+			~TransferOutput();
+
+	void		Start( int workers );
+	void		Finish();
+
+	TransferRecord	*Get( TransferOutputType type );
+	void		Put( TransferRecord *r );
+	int		PutWait( TransferRecord *r );
+
+	void		Drain( ClientUser *master );
+
+	// Counts for the last Transfer()
+
+	int		records;	// delivered to the master
+	int		deepest;	// most queued at once
+	int		waits;		// times a worker waited for room
+
+    private:
+	void		Deliver( ClientUser *master, TransferRecord *r );
+
+	std::mutex	mutex;
+	std::condition_variable	more;	// records queued, or workers done
+	std::condition_variable	room;	// records delivered
+
+	std::deque< TransferRecord * >	queue;
+	std::vector< TransferRecord * >	spare;
+
+	int		queued;		// taken by Get(), not yet delivered
+	int		running;	// workers not yet finished
+} ;
+
+TransferOutput::TransferOutput()
+{
+	records = deepest = waits = 0;
+	queued = running = 0;
+}
+
+TransferOutput::~TransferOutput()
+{
+	for( size_t i = 0; i < spare.size(); i++ )
+	    delete spare[i];
+}
+
+void
+TransferOutput::Start( int workers )
+{
+	std::lock_guard< std::mutex > lock( mutex );
+
+	running = workers;
+	records = deepest = waits = 0;
+}
+
+void
+TransferOutput::Finish()
+{
+	{
+	    std::lock_guard< std::mutex > lock( mutex );
+	    --running;
+	}
+
+	more.notify_one();
+}
+
+TransferRecord *
+TransferOutput::Get( TransferOutputType type )
+{
+	TransferRecord *r;
+
+	std::unique_lock< std::mutex > lock( mutex );
+
+	if( queued >= OUTPUT_QUEUE_MAX )
+	{
+	    ++waits;
+
+	    while( queued >= OUTPUT_QUEUE_MAX )
+		room.wait( lock );
+	}
+
+	if( ++queued > deepest )
+	    deepest = queued;
+
+	if( spare.size() )
+	{
+	    r = spare.back();
+	    spare.pop_back();
+	}
+	else
+	    r = new TransferRecord;
+
+	r->type = type;
+	r->delivered = 0;
+
+	return r;
+}
+
+void
+TransferOutput::Put( TransferRecord *r )
+{
+	{
+	    std::lock_guard< std::mutex > lock( mutex );
+	    queue.push_back( r );
+	}
+
+	more.notify_one();
+}
+
+int
+TransferOutput::PutWait( TransferRecord *r )
+{
+	int delivered = 0;
+
+	r->delivered = &delivered;
+
+	Put( r );
+
+	std::unique_lock< std::mutex > lock( mutex );
+
+	while( !delivered )
+	    room.wait( lock );
+
+	int result = r->result;
+
+	if( spare.size() < OUTPUT_SPARE )
+	    spare.push_back( r );
+	else
+	    delete r;
+
+	return result;
+}
+
+void
+TransferOutput::Drain( ClientUser *master )
+{
+	std::deque< TransferRecord * > batch;
+	std::unique_lock< std::mutex > lock( mutex );
+
+	for( ;; )
+	{
+	    while( queue.empty() && running )
+		more.wait( lock );
+
+	    // Done only once the workers have finished and the queue
+	    // is empty.
+
+	    if( queue.empty() )
+		return;
+
+	    batch.swap( queue );
+
+	    lock.unlock();
+
+	    for( size_t i = 0; i < batch.size(); i++ )
+		Deliver( master, batch[i] );
+
+	    lock.lock();
+
+	    for( size_t i = 0; i < batch.size(); i++ )
+	    {
+		TransferRecord *r = batch[i];
+
+		--queued;
+		++records;
+
+		// PutWait() recycles its own record.
+
+		if( r->delivered )
+		    *r->delivered = 1;
+		else if( spare.size() < OUTPUT_SPARE )
+		    spare.push_back( r );
+		else
+		    delete r;
+	    }
+
+	    batch.clear();
+
+	    room.notify_all();
+	}
+}
+
+void
+TransferOutput::Deliver( ClientUser *master, TransferRecord *r )
+{
+	switch( r->type )
+	{
+	case TO_HANDLEERROR:
+	    master->HandleError( &r->err );
+	    break;
+	case TO_MESSAGE:
+	    master->Message( &r->err );
+	    break;
+	case TO_OUTPUTERROR:
+	    master->OutputError( r->data.Text() );
+	    break;
+	case TO_OUTPUTINFO:
+	    master->OutputInfo( r->level, r->data.Text() );
+	    break;
+	case TO_OUTPUTBINARY:
+	    master->OutputBinary( r->data.Text(), r->data.Length() );
+	    break;
+	case TO_OUTPUTTEXT:
+	    master->OutputText( r->data.Text(), r->data.Length() );
+	    break;
+	case TO_OUTPUTSTAT:
+	    master->OutputStat( &r->dict );
+	    break;
+	case TO_OUTPUTSTATPARTIAL:
+	    r->result = master->OutputStatPartial( &r->dict );
+	    break;
+	}
+}
+
 class ThreadedTransfer : public ClientTransfer, public ClientUser
 {
 	public:
 
+	    ThreadedTransfer( Client *parent = 0 ) : parent( parent ) {}
+
 	    int     Transfer( ClientApi *client,
 	                      ClientUser *ui,
 	                      const char *cmd,
@@ -59,86 +453,118 @@ class ThreadedTransfer : public ClientTransfer, public ClientUser
 
 	private:
 
-	    int		RunTransfer( ClientApi *client,
+	    void	Setup( ClientApi *client,
+	                       StrDict *pVars,
+	                       TransferSetup *s );
+
+	    Client	*Connect( TransferSetup *s, ClientUser *ui );
+
+	    int		RunTransfer( Client *child,
+	                             TransferSetup *s,
 	                             ClientUser *ui,
 	                             const char *cmd,
-	                             StrArray *args,
-	                             StrDict *pVars );
+	                             StrArray *args );
+
+	    void	CopyStat( TransferRecord *r, StrDict *varList );
 
 	    ClientUser* master;
-	    std::mutex mutex;
-	    ThreadedKeepAlive keepAlive;
+	    Client*	parent;
+	    TransferOutput output;
 };
 
-int
-ThreadedTransfer::RunTransfer( ClientApi *client,
-	                       ClientUser *ui,
-	                       const char *cmd,
-	                       StrArray *args,
-	                       StrDict *pVars )
+void
+ThreadedTransfer::Setup( ClientApi *client,
+	                 StrDict *pVars,
+	                 TransferSetup *s )
 {
-	// Various parts of the P4API are not thread-safe.  E.g. a crash was
-	// seen in client->GetPassword().
-	mutex.lock();
+	StrRef var, val;
 
+	for( int j = 0; pVars->GetVar( j++, var, val ); )
+	    s->pVars.SetVar( var, val );
+
+	s->port.Set( client->GetPort() );
+	s->user.Set( client->GetUser() );
+	s->client.Set( client->GetClient() );
+	s->password.Set( client->GetPassword() );
+	s->prog.Set( client->GetProg() );
+	s->version.Set( client->GetVersion() );
+	s->trans = client->GetTrans();
+	s->keepAlive = client->GetBreak() ? client->GetBreak()
+	                                  : &threadedKeepAlive;
+
+	s->key << s->port << "\n" << s->user << "\n" << s->client << "\n"
+	       << s->password << "\n" << s->prog << "\n" << s->trans;
+
+	for( int j = 0; s->pVars.GetVar( j++, var, val ); )
+	    s->key << "\n" << var << "=" << val;
+}
+
+Client *
+ThreadedTransfer::Connect( TransferSetup *s, ClientUser *ui )
+{
 	Error e;
-	ClientApi child;
+	Client *child = new Client;
 	StrRef var, val;
 
-	for( int j = 0; pVars->GetVar( j++, var, val ); )
-	    child.SetProtocol( var.Text(), val.Text() );
+	for( int j = 0; s->pVars.GetVar( j++, var, val ); )
+	    child->SetProtocol( var.Text(), val.Text() );
 
-	child.SetProtocol( P4Tag::v_api, "99999" );
-	child.SetProtocol( P4Tag::v_enableStreams, "" );
-	child.SetProtocol( P4Tag::v_enableGraph, "" );
-	child.SetProtocol( P4Tag::v_expandAndmaps, "" );
+	child->SetProtocol( P4Tag::v_api, "99999" );
+	child->SetProtocol( P4Tag::v_enableStreams, "" );
+	child->SetProtocol( P4Tag::v_enableGraph, "" );
+	child->SetProtocol( P4Tag::v_expandAndmaps, "" );
 
-	if( client->GetTrans() )
-	    child.SetTrans( client->GetTrans() );
-	child.SetPort( &client->GetPort() );
-	child.SetUser( &client->GetUser() );
-	child.SetClient( &client->GetClient() );
+	if( s->trans )
+	    child->SetTrans( s->trans );
+	child->SetPort( &s->port );
+	child->SetUser( &s->user );
+	child->SetClient( &s->client );
 
-	if( client->GetPassword().Length() )
-	    child.SetPassword( &client->GetPassword() );
+	if( s->password.Length() )
+	    child->SetPassword( &s->password );
 
-	child.SetProtocolV( "tag" );
-	child.SetProg( client->GetProg().Text() );
+	child->SetProtocolV( "tag" );
+	child->SetProg( &s->prog );
 
-	child.Init( &e );
-	child.SetVersion( client->GetVersion().Text() );
-	child.SetBreak( client->GetBreak() ? client->GetBreak() : &keepAlive );
+	// Connections are made in parallel: Init() reads only the
+	// child's own settings, copied into the TransferSetup.
 
-	// Unlock here since we're past most of the issues the P4API
-	// has with shared data and so we can execute in parallel.
-	// also, need to unlock before error check
-	mutex.unlock();
+	child->Init( &e );
+	child->SetVersion( &s->version );
 
 	if( e.Test() )
 	{
 	    ui->HandleError( &e );
-	    return 1;
+	    delete child;
+	    return 0;
 	}
 
+	return child;
+}
+
+int
+ThreadedTransfer::RunTransfer( Client *child,
+	                       TransferSetup *s,
+	                       ClientUser *ui,
+	                       const char *cmd,
+	                       StrArray *args )
+{
+	int errors = child->GetErrors();
+
+	child->SetBreak( s->keepAlive );
+
 	char** a = new char*[ args->Count() ];
 
 	for( int j = 0; j < args->Count(); j++ )
 	    a[ j ] = args->Get( j )->Text();
 
-	child.SetArgv( args->Count(), a );
-	child.Run( cmd, ui );
+	child->SetArgv( args->Count(), a );
+	child->Run( cmd, ui );
 
 	delete[] a;
-	child.Final( &e );
-
-	if( e.Test() )
-	{
-	    ui->HandleError( &e );
-	    return 1;
-	}
 
 	// Errors like MsgClient::ClobberFile are only detected like this.
-	if( child.GetErrors() )
+	if( child->GetErrors() > errors )
 	    return 1;
 
 	return 0;
@@ -155,14 +581,77 @@ ThreadedTransfer::Transfer( ClientApi *client,
 {
 	master = ui;
 
+	TransferSetup s;
+	Setup( client, &pVars, &s );
+
+	// Start afresh if the last transfer's connections were made
+	// for another user, client, etc.
+
+	TransferPool *pool = 0;
+
+	if( parent )
+	{
+	    Error pe;
+	    pool = TransferPool::GetHandle( parent, &pe );
+	}
+
+	if( pool && pool->key != s.key )
+	{
+	    pool->Trim( 0 );
+	    pool->key.Set( s.key );
+	}
+
 	std::vector< std::future< int > > ts;
 	ts.reserve( threads + 1 );
 
-	auto fn = [&]( ClientApi *client, ClientUser *ui, const char *cmd,
-	               StrArray *args, StrDict *pVars )
+	// Each worker tells the output queue when it's done, however
+	// it ends.
+
+	struct WorkerDone {
+	    TransferOutput *output;
+	    ~WorkerDone() { output->Finish(); }
+	} ;
+
+	auto fn = [&]( ClientUser *ui, const char *cmd, StrArray *args )
 	    {
+	        WorkerDone done = { &output };
+
 	        P4Libraries::InitializeThread( P4LIBRARIES_INIT_P4, e );
-	        const int r = RunTransfer( client, ui, cmd, args, pVars );
+
+	        // Reuse a pooled connection, or make one.
+
+	        Client *child = pool ? pool->Take() : 0;
+
+	        if( !child )
+	            child = Connect( &s, ui );
+
+	        int r = 1;
+
+	        if( child )
+	        {
+	            r = RunTransfer( child, &s, ui, cmd, args );
+
+	            if( pool && !child->Dropped() )
+	            {
+	                pool->Give( child );
+	                child = 0;
+	            }
+	        }
+
+	        if( child )
+	        {
+	            Error fe;
+	            child->Final( &fe );
+
+	            if( fe.Test() )
+	            {
+	                ui->HandleError( &fe );
+	                r = 1;
+	            }
+
+	            delete child;
+	        }
+
 	        P4Libraries::ShutdownThread( P4LIBRARIES_INIT_P4, e );
 	        return r;
 	    };
@@ -173,9 +662,20 @@ ThreadedTransfer::Transfer( ClientApi *client,
 	const bool extState = client->ExtensionsEnabled();
 	client->DisableExtensions();
 
+	output.Start( threads );
+
 	for( int i = 0; i < threads; i++ )
 	    ts.emplace_back( std::async( std::launch::async, fn,
-	                                 client, this, cmd, &args, &pVars ) );
+	                                 this, cmd, &args ) );
+
+	// Deliver the workers' output until they've all finished.
+
+	output.Drain( master );
+
+	if( p4debug.GetLevel( DT_NET ) >= 2 )
+	    p4debug.printf( "parallel output: %d records, %d deepest, "
+	                    "%d waits\n", output.records, output.deepest,
+	                    output.waits );
 
 	int es = 0;
 
@@ -189,6 +689,9 @@ ThreadedTransfer::Transfer( ClientApi *client,
 	    catch( const std::exception& e )
 	    {}
 
+	if( pool )
+	    pool->Trim( p4tunable.Get( P4TUNE_NET_PARALLEL_POOL ) );
+
 	if( !sigState )
 	    signaler.Enable();
 
@@ -201,65 +704,79 @@ ThreadedTransfer::Transfer( ClientApi *client,
 void
 ThreadedTransfer::HandleError( Error *err )
 {
-	std::lock_guard< std::mutex > lock( mutex );
-
-	master->HandleError( err );
+	TransferRecord *r = output.Get( TO_HANDLEERROR );
+	r->err = *err;
+	output.Put( r );
 }
 
 void
 ThreadedTransfer::Message( Error *err )
 {
-	std::lock_guard< std::mutex > lock( mutex );
-
-	master->Message( err );
+	TransferRecord *r = output.Get( TO_MESSAGE );
+	r->err = *err;
+	output.Put( r );
 }
 
 void
 ThreadedTransfer::OutputError( const char *errBuf )
 {
-	std::lock_guard< std::mutex > lock( mutex );
-
-	master->OutputError( errBuf );
+	TransferRecord *r = output.Get( TO_OUTPUTERROR );
+	r->data.Set( errBuf );
+	output.Put( r );
 }
 
 void
 ThreadedTransfer::OutputInfo( char level, const char *data )
 {
-	std::lock_guard< std::mutex > lock( mutex );
-
-	master->OutputInfo( level, data );
+	TransferRecord *r = output.Get( TO_OUTPUTINFO );
+	r->level = level;
+	r->data.Set( data );
+	output.Put( r );
 }
 
 void
 ThreadedTransfer::OutputBinary( const char *data, int length )
 {
-	std::lock_guard< std::mutex > lock( mutex );
-
-	master->OutputBinary( data, length );
+	TransferRecord *r = output.Get( TO_OUTPUTBINARY );
+	r->data.Set( data, length );
+	output.Put( r );
 }
 
 void
 ThreadedTransfer::OutputText( const char *data, int length )
 {
-	std::lock_guard< std::mutex > lock( mutex );
-
-	master->OutputText( data, length );
+	TransferRecord *r = output.Get( TO_OUTPUTTEXT );
+	r->data.Set( data, length );
+	output.Put( r );
 }
 
 void
 ThreadedTransfer::OutputStat(StrDict *varList )
 {
-	std::lock_guard< std::mutex > lock( mutex );
-
-	master->OutputStat( varList );
+	TransferRecord *r = output.Get( TO_OUTPUTSTAT );
+	CopyStat( r, varList );
+	output.Put( r );
 }
 
 int
 ThreadedTransfer::OutputStatPartial( StrDict *varList )
 {
-	std::lock_guard< std::mutex > lock( mutex );
+	TransferRecord *r = output.Get( TO_OUTPUTSTATPARTIAL );
+	CopyStat( r, varList );
+	return output.PutWait( r );
+}
+
+void
+ThreadedTransfer::CopyStat( TransferRecord *r, StrDict *varList )
+{
+	StrRef var, val;
+
+	// Clear() keeps the StrBufDict's entries, to be reused.
+
+	r->dict.Clear();
 
-	return master->OutputStatPartial( varList );
+	for( int i = 0; varList->GetVar( i, var, val ); i++ )
+	    r->dict.SetVar( var, val );
 }
 
 ClientProgress *
@@ -404,7 +921,7 @@ clientReceiveFiles( Client *client, Error *e )
 	    ourTransfer = 1;
 
 # ifdef HAS_CPP11
-	    transfer = new ThreadedTransfer;
+	    transfer = new ThreadedTransfer( client );
 # else
 	    transfer = new P4ExecTranfer;
 # endif
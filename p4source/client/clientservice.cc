@@ -26,6 +26,7 @@
 # include <mapapi.h>
 # include <runcmd.h>
 # include <handler.h>
+# include <arena.h>
 # include <rpc.h>
 # include <md5.h>
 # include <mangle.h>
@@ -72,6 +73,7 @@
 # include "client.h"
 # include "clientprog.h"
 # include "clientaltsynchandler.h"
+# include "clientwriter.h"
 
 # define SSOMAXLENGTH 131072    // max sso message 128k
 
@@ -150,6 +152,8 @@ ClientFile::ClientFile( FileSys *fs )
 	checksum = 0;
 	matchDict = 0;
 	progress = 0;
+	writer = 0;
+	writesQueued = 0;
 
 # ifdef USE_CDC
 	chunkOffsetTree = 0;
@@ -158,6 +162,9 @@ ClientFile::ClientFile( FileSys *fs )
 
 ClientFile::~ClientFile()
 {
+	if( writer )
+	    writer->Wait( this );
+
 	delete file;
 	delete indirectFile;
 	delete checksum;
@@ -169,6 +176,18 @@ ClientFile::~ClientFile()
 # endif
 }
 
+void *
+ClientFile::operator new( size_t n )
+{
+	return Arena::Alloc( Arena::Current(), n );
+}
+
+void
+ClientFile::operator delete( void *p )
+{
+	Arena::Free( p );
+}
+
 /*
  * ProgressHandle - progress indicator handle
  */
@@ -589,6 +608,12 @@ clientOpenFile( Client *client, Error *e )
 	if( (client_nullsync = p4tunable.Get( P4TUNE_FILESYS_CLIENT_NULLSYNC) ) )
 	    return;
 
+	// Character set translators are shared between files, so
+	// finish writing any other file before setting this one up.
+
+	if( client->writer )
+	    client->writer->WaitAll();
+
 	ClientFile *f;
 	FileSys *fs = 0;
 
@@ -848,6 +873,19 @@ clientOpenFile( Client *client, Error *e )
 	// Character set translations
 	f->file->Translator( ClientSvc::XCharset( client, FromServer ) );
 
+	// Write behind, if asked.  Symlinks are written synchronously:
+	// clientCloseFile() checks their target.
+
+	if( p4tunable.Get( P4TUNE_FILESYS_CLIENT_WRITEBEHIND ) &&
+	    !e->Test() && !f->file->IsSymlink() )
+	{
+	    if( !client->writer )
+		client->writer = new ClientWriter(
+		    p4tunable.Get( P4TUNE_FILESYS_CLIENT_WRITEBEHIND ) );
+
+	    client->writer->Open( f );
+	}
+
 	// If anything went wrong, we mark the handle so that
 	// the rest of the write protocol is honored (but ignored).
 
@@ -859,6 +897,29 @@ clientOpenFile( Client *client, Error *e )
 	client->OutputError( e );
 }
 
+/*
+ * clientWaitFile() - finish a file's queued writes, reporting any error
+ */
+
+static void
+clientWaitFile( Client *client, ClientFile *f, Error *e )
+{
+	if( !f->writer )
+	    return;
+
+	f->writer->Wait( f );
+
+	// Mark handle with the error, report and clear it:
+	// as if clientWriteFile() had written the data itself.
+
+	if( f->writeError.Test() )
+	{
+	    *e = f->writeError;
+	    f->SetError( e );
+	    client->OutputError( e );
+	}
+}
+
 void
 clientWriteFile( Client *client, Error *e )
 {
@@ -897,7 +958,12 @@ clientWriteFile( Client *client, Error *e )
 	    __etoa_l( data->Text(), data->Length() );
 # endif
 
-	f->file->Write( data, e );
+	// Queued writes report their errors at clientCloseFile().
+
+	if( f->writer )
+	    f->writer->Write( f, data );
+	else
+	    f->file->Write( data, e );
 
 	if( !e->Test() && f->file->IsSymlink() && data->Length() )
 	    f->symTarget << data;
@@ -1418,6 +1484,11 @@ clientWriteFileChunks( Client *client, Error *e )
 	    return;
 	}
 
+	clientWaitFile( client, f, e );
+
+	if( f->IsError() )
+	    return;
+
 	CDCStats *cdcStats = 0;
 	if( p4debug.GetLevel( DT_DLTXFER ) > DL_NONE )
 	{
@@ -1600,6 +1671,10 @@ clientCloseFile( Client *client, Error *e )
 	if( e->Test() )
 	    return;
 
+	// Finish writing before the file is closed and renamed.
+
+	clientWaitFile( client, f, e );
+
 	// Check for illegal symlinks
 	//
 	// Block symlinks outside the workspace if filesys.restictsymlinks=1
@@ -4574,6 +4649,11 @@ clientFstatInfo( Client *client, Error *e )
 	// XXX hmmm... since we potentially have different translations
 	// which one should we choose
 
+	// A ClientUser taking batches gets the record added to one.
+
+	if( client->FstatBatchAppend( client->translated, 1 ) )
+	    return;
+
 	// Append the final fstat partial to the existing partials
 	client->FstatPartialAppend( client->translated );
 
@@ -4590,6 +4670,9 @@ clientFstatPartial( Client *client, Error *e )
 	// XXX hmmm... since we potentially have different translations
 	// which one should we choose
 
+	if( client->FstatBatchAppend( client->translated, 0 ) )
+	    return;
+
 	// Append the partial to the existing partials
 	client->FstatPartialAppend( client->translated );
 
@@ -83,12 +83,18 @@ class ChunkOffsetTree;
 # endif
 
 class ProgressReport;
+class ClientWriter;
 class ClientFile : public LastChance {
 
     public:
 			ClientFile( FileSys *fs = 0 );
 			~ClientFile();
 
+	// allocated from the current Arena, if any (see arena.h)
+
+	static void	*operator new( size_t n );
+	static void	operator delete( void *p );
+
     public:
 
 	FileSys		*file;
@@ -108,6 +114,12 @@ class ClientFile : public LastChance {
 
 	ProgressReport	*progress;
 
+	// Write-behind: see clientwriter.h
+
+	ClientWriter	*writer;
+	int		writesQueued;
+	Error		writeError;
+
 # ifdef USE_CDC
 	ChunkOffsetTree	*chunkOffsetTree;
 # endif
@@ -46,6 +46,7 @@
 
 # include "clientservice.h"
 # include "clientaltsynchandler.h"
+# include "clienttraverse.h"
 
 /*
  * ReconcileHandle - handle reconcile's list of files to skip when adding
@@ -1005,6 +1006,12 @@ clientReconcileAdd( Client *client, Error *e )
 				      map, files, dirs, idx,
 				      depotFiles, ddx, config, e );
 	}
+	else if( p4tunable.Get( P4TUNE_FILESYS_SCAN_THREADS ) > 1 )
+	    clientTraverseDirsParallel( client, dir->Text(), traverse != 0,
+				skipIgnore != 0, sendDigest != 0, map,
+				files, sizes, times, digests, hasIndex,
+				recHandle ? recHandle->pathArray : 0, config,
+				p4tunable.Get( P4TUNE_FILESYS_SCAN_THREADS ), e );
 	else
 	    clientTraverseDirs( client, dir->Text(), traverse != 0,
 				skipIgnore != 0, sendDigest != 0, map,
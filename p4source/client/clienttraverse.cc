@@ -0,0 +1,616 @@
+/*
+ * Copyright 1995, 2024 Perforce Software.  All rights reserved.
+ *
+ * This file is part of Perforce - the FAST SCM System.
+ */
+
+/*
+ * clienttraverse.cc - parallel workspace scan for reconcile/status
+ *
+ * The serial clientTraverseDirs() interleaves three kinds of work: the
+ * directory listing and stat() of every entry, the filtering of entries
+ * through the map, the ignore rules and the have list, and the digest of
+ * every file reported.  Only the filtering depends on the order in which
+ * files are visited, so the parallel scan splits the work in three passes:
+ *
+ *	Walk()	 - a pool of threads lists and stats directories.  Each
+ *		   thread keeps a deque of directories to scan; it pops
+ *		   work from the back of its own deque and steals from the
+ *		   front of the others' when its own runs dry.  Ignored
+ *		   directories are not descended into.
+ *
+ *	Replay() - the calling thread walks the resulting tree depth first,
+ *		   in the order the serial scan would have, applying the same
+ *		   filtering and filling the files/sizes/times arrays.
+ *
+ *	Digest() - the pool digests the reported files, and the results
+ *		   are stored in report order.
+ */
+
+# include <stdhdrs.h>
+
+# include <strbuf.h>
+# include <strdict.h>
+# include <strarray.h>
+# include <strtable.h>
+# include <vararray.h>
+# include <error.h>
+# include <runcmd.h>
+# include <mapapi.h>
+# include <handler.h>
+# include <rpc.h>
+# include <i18napi.h>
+# include <charcvt.h>
+# include <transdict.h>
+# include <ignore.h>
+# include <debug.h>
+# include <tunable.h>
+
+# include <filesys.h>
+# include <pathsys.h>
+# include <enviro.h>
+
+# include "clientuser.h"
+# include "client.h"
+# include "clientservice.h"
+# include "clienttraverse.h"
+# include "p4libs.h"
+
+# ifdef HAS_CPP11
+# include <atomic>
+# include <condition_variable>
+# include <deque>
+# include <thread>
+# include <mutex>
+# include <vector>
+
+/*
+ * TraverseDir - a scanned directory, entries sorted as the serial scan
+ * TraverseEntry - a stat'ed directory entry
+ */
+
+class TraverseDir;
+
+class TraverseEntry {
+
+    public:
+			TraverseEntry() : stat( 0 ), size( 0 ), modTime( 0 ),
+			                  dir( 0 ) {}
+			~TraverseEntry();
+
+	StrBuf		path;
+	int		stat;
+	P4INT64		size;
+	P4INT64		modTime;
+	TraverseDir	*dir;
+} ;
+
+class TraverseDir {
+
+    public:
+			TraverseDir() : rejected( 0 ) {}
+			~TraverseDir()
+			{
+			    for( int i = 0; i < entries.Count(); i++ )
+			        delete (TraverseEntry *)entries.Get( i );
+			}
+
+	StrBuf		path;
+	int		rejected;
+	Error		error;
+	VarArray	entries;
+} ;
+
+TraverseEntry::~TraverseEntry()
+{
+	delete dir;
+}
+
+class TraverseQueue {
+
+    public:
+	std::mutex			mutex;
+	std::deque< TraverseDir * >	work;
+} ;
+
+class TraverseWalker {
+
+    public:
+			TraverseWalker( Client *client, int traverse,
+			                int noIgnore, const char *config,
+			                int threads );
+			~TraverseWalker();
+
+	void		Walk( TraverseDir *root );
+	void		Replay( TraverseDir *d, MapApi *map,
+			        StrArray *files, StrArray *sizes,
+			        StrArray *times, StrArray *paths,
+			        int &hasIndex, StrArray *hasList, Error *e );
+	void		Digest( StrArray *paths, StrArray *digests, Error *e );
+
+    private:
+	void		Launch( void (TraverseWalker::*work)( int ) );
+
+	void		WalkWork( int worker );
+	TraverseDir	*WalkNext( int worker );
+	void		WalkWake( int all );
+	void		Scan( TraverseDir *d, int worker );
+
+	void		DigestWork( int worker );
+
+	const char	*Translate( const char *name, int len );
+
+	Client		*client;
+	int		traverse;
+	int		noIgnore;
+	const char	*config;
+	int		threads;
+	const StrPtr	*ignored;
+
+	FileSys		**fileSys;
+	PathSys		**pathSys;
+
+	TraverseQueue	*queues;
+	std::atomic<int> pending;	// dirs queued or being scanned
+	std::atomic<int> queued;	// dirs queued
+	std::mutex	waitMutex;	// idle workers wait on waitCond
+	std::condition_variable waitCond;
+	std::mutex	ignoreMutex;
+
+	StrArray	*digestPaths;
+	StrBuf		*digestOut;
+	Error		*digestErr;
+	std::atomic<int> digestNext;
+} ;
+
+TraverseWalker::TraverseWalker( Client *client, int traverse, int noIgnore,
+	                        const char *config, int threads )
+{
+	this->client = client;
+	this->traverse = traverse;
+	this->noIgnore = noIgnore;
+	this->config = config;
+	this->threads = threads;
+	ignored = &client->GetIgnoreFile();
+
+	// One FileSys and PathSys per thread, created here so that the
+	// ClientUser is only ever asked for them from the calling thread.
+
+	fileSys = new FileSys *[ threads ];
+	pathSys = new PathSys *[ threads ];
+	queues = new TraverseQueue[ threads ];
+
+	for( int i = 0; i < threads; i++ )
+	{
+	    fileSys[i] = client->GetUi()->File( FST_BINARY );
+	    fileSys[i]->SetContentCharSetPriv( client->content_charset );
+	    fileSys[i]->Translator( ClientSvc::XCharset( client, FromClient ) );
+	    pathSys[i] = PathSys::Create();
+	    pathSys[i]->SetCharSet( fileSys[i]->GetCharSetPriv() );
+	}
+
+	pending = 0;
+	queued = 0;
+	digestPaths = 0;
+	digestOut = 0;
+	digestErr = 0;
+	digestNext = 0;
+}
+
+TraverseWalker::~TraverseWalker()
+{
+	for( int i = 0; i < threads; i++ )
+	{
+	    delete fileSys[i];
+	    delete pathSys[i];
+	}
+
+	delete []fileSys;
+	delete []pathSys;
+	delete []queues;
+}
+
+void
+TraverseWalker::Launch( void (TraverseWalker::*work)( int ) )
+{
+	// The calling thread is worker 0.
+
+	std::vector< std::thread > ts;
+	ts.reserve( threads );
+
+	auto fn = [this, work]( int worker )
+	    {
+	        P4Libraries::InitializeThread( P4LIBRARIES_INIT_P4, 0 );
+	        (this->*work)( worker );
+	        P4Libraries::ShutdownThread( P4LIBRARIES_INIT_P4, 0 );
+	    };
+
+	for( int i = 1; i < threads; i++ )
+	    ts.emplace_back( fn, i );
+
+	(this->*work)( 0 );
+
+	for( size_t i = 0; i < ts.size(); i++ )
+	    ts[i].join();
+}
+
+void
+TraverseWalker::Walk( TraverseDir *root )
+{
+	pending = 1;
+	queued = 1;
+	queues[0].work.push_back( root );
+
+	Launch( &TraverseWalker::WalkWork );
+}
+
+void
+TraverseWalker::WalkWork( int worker )
+{
+	for( ;; )
+	{
+	    TraverseDir *d = WalkNext( worker );
+
+	    if( d )
+	    {
+	        // Scan() queues d's subdirectories before we let go of d,
+	        // so pending can only reach 0 once the whole tree is done.
+
+	        Scan( d, worker );
+
+	        if( !--pending )
+	            WalkWake( 1 );
+
+	        continue;
+	    }
+
+	    // Nothing to steal: sleep until there is, or we're done.
+
+	    std::unique_lock< std::mutex > lock( waitMutex );
+	    waitCond.wait( lock, [this]{ return !pending || queued > 0; } );
+
+	    if( !pending )
+	        break;
+	}
+}
+
+void
+TraverseWalker::WalkWake( int all )
+{
+	// Taking the lock orders this after any waiter's check of
+	// pending and queued, so it can't miss the notify.
+
+	{
+	    std::lock_guard< std::mutex > lock( waitMutex );
+	}
+
+	if( all )
+	    waitCond.notify_all();
+	else
+	    waitCond.notify_one();
+}
+
+TraverseDir *
+TraverseWalker::WalkNext( int worker )
+{
+	TraverseDir *d = 0;
+
+	// Our own work first, newest first: it's nearest the disk blocks
+	// we just read.
+
+	{
+	    TraverseQueue &q = queues[ worker ];
+	    std::lock_guard< std::mutex > lock( q.mutex );
+
+	    if( !q.work.empty() )
+	    {
+	        d = q.work.back();
+	        q.work.pop_back();
+	        --queued;
+	        return d;
+	    }
+	}
+
+	// Steal the oldest (and so likely largest) work of another thread.
+
+	for( int i = 1; i < threads; i++ )
+	{
+	    TraverseQueue &q = queues[ ( worker + i ) % threads ];
+	    std::lock_guard< std::mutex > lock( q.mutex );
+
+	    if( !q.work.empty() )
+	    {
+	        d = q.work.front();
+	        q.work.pop_front();
+	        --queued;
+	        return d;
+	    }
+	}
+
+	return 0;
+}
+
+void
+TraverseWalker::Scan( TraverseDir *d, int worker )
+{
+	FileSys *f = fileSys[ worker ];
+	PathSys *p = pathSys[ worker ];
+
+	// Directory might be ignored, bail.  Ignore caches the rules of
+	// the last directory it looked at, so it is not shared unlocked.
+
+	if( !noIgnore )
+	{
+	    std::lock_guard< std::mutex > lock( ignoreMutex );
+
+	    d->rejected = client->GetIgnore()->RejectDir( d->path,
+	                                                     *ignored, config );
+	    if( d->rejected )
+	        return;
+	}
+
+	f->Set( d->path );
+	StrArray *a = f->ScanDir( &d->error );
+
+	if( d->error.Test() )
+	{
+	    delete a;
+	    return;
+	}
+
+	// Sort in case sensitivity of client
+
+	a->Sort( !StrBuf::CaseUsage() );
+
+	TraverseQueue &q = queues[ worker ];
+
+	for( int i = 0; i < a->Count(); i++ )
+	{
+	    TraverseEntry *t = new TraverseEntry;
+	    d->entries.Put( t );
+
+	    p->SetLocal( d->path, *a->Get(i) );
+	    f->Set( *p );
+
+	    t->path = *f->Path();
+	    t->stat = f->Stat();
+
+	    if( ( t->stat & FSF_DIRECTORY ) && !( t->stat & FSF_SYMLINK ) )
+	    {
+	        if( !traverse )
+	            continue;
+
+	        t->dir = new TraverseDir;
+	        t->dir->path = t->path;
+
+	        ++pending;
+
+	        {
+	            std::lock_guard< std::mutex > lock( q.mutex );
+	            q.work.push_back( t->dir );
+	            ++queued;
+	        }
+
+	        WalkWake( 0 );
+	    }
+	    else if( ( t->stat & FSF_DIRECTORY ) ||
+	             ( t->stat & FSF_EXISTS ) || ( t->stat & FSF_SYMLINK ) )
+	    {
+	        t->size = f->GetSize();
+	        t->modTime = f->StatModTime();
+	    }
+	}
+
+	delete a;
+}
+
+const char *
+TraverseWalker::Translate( const char *name, int len )
+{
+	// With unicode server and client using character set, we need
+	// to send files back as utf8.
+
+	if( client == client->translated )
+	    return name;
+
+	CharSetCvt *cvt = ( (TransDict *)client->transfname )->ToCvt();
+	const char *fileName = cvt->FastCvt( name, len );
+
+	return fileName ? fileName : name;
+}
+
+void
+TraverseWalker::Replay( TraverseDir *d, MapApi *map, StrArray *files,
+	                StrArray *sizes, StrArray *times, StrArray *paths,
+	                int &hasIndex, StrArray *hasList, Error *e )
+{
+	// This is the loop of clientTraverseDirs(), over stat results
+	// already in hand.  Keep the two in step.
+
+	if( d->rejected )
+	    return;
+
+	if( d->error.Test() )
+	{
+	    // report error but keep moving
+
+	    e->Merge( d->error );
+	    client->OutputError( e );
+	    return;
+	}
+
+	StrBuf from;
+	StrBuf to;
+	int matched;
+
+	for( int i = 0; i < d->entries.Count(); i++ )
+	{
+	    TraverseEntry *t = (TraverseEntry *)d->entries.Get( i );
+	    const char *fileName = Translate( t->path.Text(), t->path.Length() );
+
+	    // Do compare with array list (skip files if possible)
+	    int cmp = -1;
+
+	    while( hasList && hasIndex < hasList->Count() )
+	    {
+	        cmp = t->path.SCompare( *hasList->Get( hasIndex ) );
+
+	        if( cmp < 0 )
+	            break;
+
+	        hasIndex++;
+
+	        if( cmp == 0 )
+	            break;
+	    }
+
+	    if( cmp == 0 )
+	        continue;
+
+	    if( t->dir )
+	    {
+	        Replay( t->dir, map, files, sizes, times, paths,
+	                hasIndex, hasList, e );
+	        continue;
+	    }
+
+	    if( ( t->stat & FSF_DIRECTORY ) && !( t->stat & FSF_SYMLINK ) )
+	        continue;
+
+	    if( !( t->stat & FSF_DIRECTORY ) &&
+	        !( t->stat & FSF_EXISTS ) && !( t->stat & FSF_SYMLINK ) )
+	        continue;
+
+	    from.Set( fileName );
+	    if( t->stat & FSF_DIRECTORY )
+	        from << "/";
+
+#ifdef OS_NT
+	    convertSlash( from.Text() );
+#endif
+
+	    if( client->protocolNocase != StrBuf::CaseUsage() )
+	    {
+	        from.SetCaseFolding( client->protocolNocase );
+	        matched = map->Translate( from, to, MapLeftRight );
+	        from.SetCaseFolding( !client->protocolNocase );
+	    }
+	    else
+	        matched = map->Translate( from, to, MapLeftRight );
+
+	    if( !matched )
+	        continue;
+
+	    if( noIgnore ||
+	        !client->GetIgnore()->Reject( t->path, *ignored, config ) )
+	    {
+	        files->Put()->Set( fileName );
+	        sizes->Put()->Set( StrNum( t->size ) );
+	        times->Put()->Set( StrNum( t->modTime ) );
+	        if( paths )
+	            paths->Put()->Set( t->path );
+	    }
+	}
+}
+
+void
+TraverseWalker::Digest( StrArray *paths, StrArray *digests, Error *e )
+{
+	digestPaths = paths;
+	digestOut = new StrBuf[ paths->Count() ];
+	digestErr = new Error[ paths->Count() ];
+	digestNext = 0;
+
+	Launch( &TraverseWalker::DigestWork );
+
+	// Hand back the digests, and any errors, in the order the files
+	// were reported.
+
+	for( int i = 0; i < paths->Count(); i++ )
+	{
+	    digests->Put()->Set( digestOut[i] );
+	    if( digestErr[i].Test() )
+	        e->Merge( digestErr[i] );
+	}
+
+	delete []digestOut;
+	delete []digestErr;
+	digestOut = 0;
+	digestErr = 0;
+	digestPaths = 0;
+}
+
+void
+TraverseWalker::DigestWork( int worker )
+{
+	FileSys *f = fileSys[ worker ];
+
+	for( int i; ( i = digestNext++ ) < digestPaths->Count(); )
+	{
+	    f->Set( *digestPaths->Get( i ) );
+	    f->Digest( &digestOut[i], &digestErr[i] );
+	}
+}
+
+void
+clientTraverseDirsParallel( Client *client, const char *dir, int traverse,
+	                    int noIgnore, int getDigests, MapApi *map,
+	                    StrArray *files, StrArray *sizes, StrArray *times,
+	                    StrArray *digests, int &hasIndex,
+	                    StrArray *hasList, const char *config,
+	                    int threads, Error *e )
+{
+	// Single files, directory symlinks and serial requests are
+	// handled by the serial scan.
+
+	FileSys *f = client->GetUi()->File( FST_BINARY );
+	f->SetContentCharSetPriv( client->content_charset );
+	f->Set( StrRef( dir ) );
+	int fstat = f->Stat();
+	delete f;
+
+	if( threads <= 1 || !( fstat & FSF_DIRECTORY ) || ( fstat & FSF_SYMLINK ) )
+	{
+	    clientTraverseDirs( client, dir, traverse, noIgnore, getDigests,
+	                        map, files, sizes, times, digests, hasIndex,
+	                        hasList, config, e );
+	    return;
+	}
+
+	TraverseWalker walker( client, traverse, noIgnore, config, threads );
+
+	TraverseDir *root = new TraverseDir;
+	root->path.Set( dir );
+
+	walker.Walk( root );
+
+	StrArray *paths = getDigests ? new StrArray : 0;
+
+	walker.Replay( root, map, files, sizes, times, paths,
+	               hasIndex, hasList, e );
+
+	delete root;
+
+	if( paths )
+	{
+	    walker.Digest( paths, digests, e );
+	    delete paths;
+	}
+}
+
+# else
+
+void
+clientTraverseDirsParallel( Client *client, const char *dir, int traverse,
+	                    int noIgnore, int getDigests, MapApi *map,
+	                    StrArray *files, StrArray *sizes, StrArray *times,
+	                    StrArray *digests, int &hasIndex,
+	                    StrArray *hasList, const char *config,
+	                    int threads, Error *e )
+{
+	clientTraverseDirs( client, dir, traverse, noIgnore, getDigests,
+	                    map, files, sizes, times, digests, hasIndex,
+	                    hasList, config, e );
+}
+
+# endif
@@ -0,0 +1,32 @@
+/*
+ * Copyright 1995, 2024 Perforce Software.  All rights reserved.
+ *
+ * This file is part of Perforce - the FAST SCM System.
+ */
+
+/*
+ * clienttraverse.h - workspace scans for reconcile/status
+ *
+ * clientTraverseDirs() - serial scan of a directory (clientservicer.cc)
+ *
+ * clientTraverseDirsParallel() - the same scan, with directory listing,
+ *	stat() and digest computation spread over 'threads' threads.
+ *	The serial filtering (map, ignore, have list) is replayed over the
+ *	results afterwards, so the files/sizes/times/digests arrays are
+ *	identical to what clientTraverseDirs() produces.
+ */
+
+class MapApi;
+
+void clientTraverseDirs( Client *client, const char *dir, int traverse,
+			 int noIgnore, int getDigests, MapApi *map,
+			 StrArray *files, StrArray *sizes, StrArray *times,
+			 StrArray *digests, int &hasIndex, StrArray *hasList,
+			 const char *config, Error *e );
+
+void clientTraverseDirsParallel( Client *client, const char *dir,
+			 int traverse, int noIgnore, int getDigests,
+			 MapApi *map, StrArray *files, StrArray *sizes,
+			 StrArray *times, StrArray *digests, int &hasIndex,
+			 StrArray *hasList, const char *config, int threads,
+			 Error *e );
@@ -27,6 +27,7 @@
 
 # include <clientapi.h>
 # include <clientprog.h>
+# include <statbatch.h>
 
 # include <diff.h>
 # include <enviro.h>
@@ -335,6 +336,13 @@ ClientUser::OutputStat( StrDict *varList )
 	OutputInfo( '0', "" );
 }
 
+void
+ClientUser::OutputStatBatch( StatBatch *batch )
+{
+	for( int r = 0; r < batch->Count(); r++ )
+	    OutputStat( batch->Record( r ) );
+}
+
 void
 ClientUser::ErrorPause( char *errBuf, Error *e )
 {
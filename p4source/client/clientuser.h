@@ -31,6 +31,7 @@
  *	protocol variable 'tag' is set:
  *
  *		OutputStat
+ *		OutputStatBatch (instead, if OutputStatBatchSize() isn't 0)
  *
  *	Used only by interactive commands that can generally be avoided:
  *
@@ -72,6 +73,14 @@
  *	ClientUser::OutputStat() - output results of 'p4 fstat'; requires
  *		calling StrDict::GetVar() to get the actual variable results.
  *
+ *	ClientUser::OutputStatBatch() - output a batch of 'p4 fstat' results,
+ *		up to OutputStatBatchSize() of them; see statbatch.h.  The
+ *		default calls OutputStat() for each.  Records still waiting
+ *		for a batch are delivered before any other output.
+ *
+ *	ClientUser::OutputStatBatchSize() - the most records to deliver to
+ *		OutputStatBatch() at once; 0 (the default) for OutputStat().
+ *
  *	ClientUser::Prompt() - prompt the user, and wait for a response.
  *		Optionally takes a noOutput flag to suppress the prompt and
  *		just collect the response.
@@ -105,6 +114,7 @@ class ClientProgress;
 class ClientTransfer;
 class ClientSSO;
 class ClientApi;
+class StatBatch;
 
 # ifdef HAS_CPP11
 #   include <mutex>
@@ -133,6 +143,10 @@ class ClientUser {
 	// The above method returns 0 to carry the fstat partials or non-0
 	// to drop them (return 1 if you print them as you get them)
 
+	virtual void	OutputStatBatch( StatBatch *batch );
+	virtual int	OutputStatBatchSize() { return 0; }
+	// With batches, fstat partials are simply added to the record
+
 	virtual void	Prompt( Error *err, StrBuf &rsp, 
 				int noEcho, Error *e );
 	virtual void	Prompt( Error *err, StrBuf &rsp,
@@ -0,0 +1,256 @@
+/*
+ * Copyright 1995, 2024 Perforce Software.  All rights reserved.
+ *
+ * This file is part of Perforce - the FAST SCM System.
+ */
+
+/*
+ * clientwriter.cc - write-behind for files sent by the server
+ *
+ * The data a block arrives in lives in the RPC receive buffer, which is
+ * reused for the next message, so Write() must copy it.  Blocks (and
+ * their buffers) are recycled, so that a steady transfer allocates
+ * nothing.
+ */
+
+# include <stdhdrs.h>
+
+# include <strbuf.h>
+# include <strdict.h>
+# include <error.h>
+# include <handler.h>
+# include <rpc.h>
+# include <filesys.h>
+
+# include "clientservice.h"
+# include "clientwriter.h"
+
+# ifdef HAS_CPP11
+# include <condition_variable>
+# include <deque>
+# include <mutex>
+# include <thread>
+# include <vector>
+
+// Blocks kept for reuse
+
+# define SPARE_BLOCKS	16
+
+/*
+ * ClientWriterBlock - a copy of one block of a file's data
+ * ClientWriterQueue - the blocks waiting to be written, and the thread
+ */
+
+struct ClientWriterBlock {
+	ClientFile	*f;
+	StrBuf		data;
+} ;
+
+struct ClientWriterQueue {
+	std::mutex		mutex;
+	std::condition_variable	more;	// blocks queued, or quit
+	std::condition_variable	done;	// blocks written
+
+	std::deque< ClientWriterBlock * >	blocks;
+	std::vector< ClientWriterBlock * >	spare;
+	std::vector< ClientFile * >		open;
+
+	std::thread		thread;
+
+	P4INT64			queued;	// bytes not yet written
+	P4INT64			limit;
+	int			pending;	// blocks not yet written
+	int			quit;
+
+	void			Run();
+} ;
+
+void
+ClientWriterQueue::Run()
+{
+	std::unique_lock< std::mutex > lock( mutex );
+
+	for( ;; )
+	{
+	    while( blocks.empty() && !quit )
+		more.wait( lock );
+
+	    // Quit only once the queue is empty.
+
+	    if( blocks.empty() )
+		return;
+
+	    ClientWriterBlock *b = blocks.front();
+	    blocks.pop_front();
+
+	    ClientFile *f = b->f;
+
+	    // Only this thread sets writeError; Wait() reads it after.
+
+	    lock.unlock();
+
+	    if( !f->writeError.Test() )
+		f->file->Write( &b->data, &f->writeError );
+
+	    lock.lock();
+
+	    queued -= b->data.Length();
+	    --pending;
+	    --f->writesQueued;
+
+	    if( spare.size() < SPARE_BLOCKS )
+		spare.push_back( b );
+	    else
+		delete b;
+
+	    done.notify_all();
+	}
+}
+
+ClientWriter::ClientWriter( int limit )
+{
+	q = new ClientWriterQueue;
+	q->queued = 0;
+	q->limit = limit;
+	q->pending = 0;
+	q->quit = 0;
+}
+
+ClientWriter::~ClientWriter()
+{
+	{
+	    std::lock_guard< std::mutex > lock( q->mutex );
+	    q->quit = 1;
+	}
+
+	q->more.notify_one();
+
+	if( q->thread.joinable() )
+	    q->thread.join();
+
+	// Files still open forget us.
+
+	for( size_t i = 0; i < q->open.size(); i++ )
+	    q->open[i]->writer = 0;
+
+	for( size_t i = 0; i < q->spare.size(); i++ )
+	    delete q->spare[i];
+
+	delete q;
+}
+
+void
+ClientWriter::Open( ClientFile *f )
+{
+	std::lock_guard< std::mutex > lock( q->mutex );
+
+	f->writer = this;
+	q->open.push_back( f );
+}
+
+void
+ClientWriter::Write( ClientFile *f, const StrPtr *data )
+{
+	ClientWriterBlock *b;
+
+	{
+	    std::unique_lock< std::mutex > lock( q->mutex );
+
+	    // Wait for room, but always let one block through.
+
+	    while( q->queued && q->queued + data->Length() > q->limit )
+		q->done.wait( lock );
+
+	    if( q->spare.size() )
+	    {
+		b = q->spare.back();
+		q->spare.pop_back();
+	    }
+	    else
+		b = new ClientWriterBlock;
+
+	    q->queued += data->Length();
+	    ++q->pending;
+	    ++f->writesQueued;
+	}
+
+	// Copy outside the lock, so as not to hold up the thread.
+
+	b->f = f;
+	b->data.Set( data );
+
+	{
+	    std::lock_guard< std::mutex > lock( q->mutex );
+
+	    q->blocks.push_back( b );
+
+	    if( !q->thread.joinable() )
+		q->thread = std::thread( &ClientWriterQueue::Run, q );
+	}
+
+	q->more.notify_one();
+}
+
+void
+ClientWriter::Wait( ClientFile *f )
+{
+	std::unique_lock< std::mutex > lock( q->mutex );
+
+	while( f->writesQueued )
+	    q->done.wait( lock );
+
+	for( size_t i = 0; i < q->open.size(); i++ )
+	    if( q->open[i] == f )
+	    {
+		q->open.erase( q->open.begin() + i );
+		break;
+	    }
+
+	f->writer = 0;
+}
+
+void
+ClientWriter::WaitAll()
+{
+	std::unique_lock< std::mutex > lock( q->mutex );
+
+	while( q->pending )
+	    q->done.wait( lock );
+}
+
+# else
+
+ClientWriter::ClientWriter( int )
+{
+	q = 0;
+}
+
+ClientWriter::~ClientWriter()
+{
+}
+
+void
+ClientWriter::Open( ClientFile * )
+{
+	// No thread: leave the file to be written directly.
+}
+
+void
+ClientWriter::Write( ClientFile *f, const StrPtr *data )
+{
+	if( !f->writeError.Test() )
+	    f->file->Write( data, &f->writeError );
+}
+
+void
+ClientWriter::Wait( ClientFile *f )
+{
+	f->writer = 0;
+}
+
+void
+ClientWriter::WaitAll()
+{
+}
+
+# endif
@@ -0,0 +1,57 @@
+/*
+ * Copyright 1995, 2024 Perforce Software.  All rights reserved.
+ *
+ * This file is part of Perforce - the FAST SCM System.
+ */
+
+/*
+ * clientwriter.h - write-behind for files sent by the server
+ *
+ * Classes Defined:
+ *
+ *	ClientWriter - writes ClientFile data on a thread of its own
+ *
+ * Description:
+ *
+ *	clientWriteFile() hands each block of a file to the ClientWriter,
+ *	which queues a copy and returns, so that the next block can be
+ *	received while this one is written.  A single thread writes the
+ *	blocks in the order they were queued.
+ *
+ *	The queue is bounded: when more than 'limit' bytes are waiting,
+ *	Write() waits for the thread to catch up.
+ *
+ *	From Open() until Wait(), only the writer's thread may use the
+ *	file's FileSys.  The first write error is kept in the ClientFile's
+ *	writeError, and the file's remaining blocks are dropped.
+ *
+ *	Without HAS_CPP11 there is no thread, and Open() leaves the file
+ *	to be written directly.
+ *
+ * Public methods:
+ *
+ *	ClientWriter::Open() - send a ClientFile's writes through the writer
+ *	ClientWriter::Write() - queue a block of data for a ClientFile
+ *	ClientWriter::Wait() - wait for a ClientFile's blocks to be written
+ *	ClientWriter::WaitAll() - wait for every queued block to be written
+ *	ClientWriter::~ClientWriter() - write anything queued, stop the thread
+ */
+
+class ClientFile;
+struct ClientWriterQueue;
+
+class ClientWriter {
+
+    public:
+			ClientWriter( int limit );
+			~ClientWriter();
+
+	void		Open( ClientFile *f );
+	void		Write( ClientFile *f, const StrPtr *data );
+	void		Wait( ClientFile *f );
+	void		WaitAll();
+
+    private:
+	ClientWriterQueue *q;
+
+} ;
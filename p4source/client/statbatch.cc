@@ -0,0 +1,323 @@
+/*
+ * Copyright 2024 Perforce Software.  All rights reserved.
+ *
+ * This file is part of Perforce - the FAST SCM System.
+ */
+
+/*
+ * statbatch.cc - fstat records, delivered many at a time
+ *
+ * A record is a run of entries (field, value) in one array, and each
+ * field has a column giving its entry in each record.  Values are
+ * copied out of the RPC receive buffer, which is reused for the next
+ * message, into one text buffer: the only allocation a record costs
+ * is when one of these has to grow.
+ */
+
+# include <stdhdrs.h>
+
+# include <strbuf.h>
+# include <strdict.h>
+# include <strarray.h>
+
+# include "statbatch.h"
+
+# include <vector>
+
+struct StatBatchEntry {
+	int		field;
+	int		off;		// into text
+	int		len;
+} ;
+
+/*
+ * StatBatchRecord - a StrDict of one record, for OutputStat()
+ */
+
+class StatBatchRecord : public StrDict {
+
+    public:
+			StatBatchRecord( StatBatch *b ) { batch = b; r = 0; }
+
+	void		Set( int r ) { this->r = r; }
+
+	StrPtr *	VGetVar( const StrPtr &var )
+			{
+			    int f = batch->FieldId( var );
+			    return f >= 0 && batch->Get( r, f, ret ) ? &ret : 0;
+			}
+
+	int		VGetVarX( int x, StrRef &var, StrRef &val )
+			{ return batch->GetVar( r, x, var, val ); }
+
+	int		VGetCount()
+			{
+			    StrRef var, val;
+			    int n = 0;
+			    while( batch->GetVar( r, n, var, val ) )
+				++n;
+			    return n;
+			}
+
+    private:
+	StatBatch	*batch;
+	int		r;
+	StrRef		ret;
+} ;
+
+struct StatBatchData {
+
+			StatBatchData( StatBatch *b ) : record( b )
+			{ starts.push_back( 0 ); }
+
+	StrArray	names;
+	std::vector< int > hash;	// field + 1 by name, 0 if empty
+	std::vector< int > guess;	// field at each position, last time
+
+	StrBuf		text;		// values, each null terminated
+	std::vector< StatBatchEntry > entries;
+	std::vector< int > starts;	// first entry of each record
+	std::vector< std::vector< int > > columns; // entry by record, or -1
+
+	StatBatchRecord	record;
+} ;
+
+static unsigned int
+StatBatchHash( const char *p, int n )
+{
+	// FNV-1a
+
+	unsigned int h = 2166136261u;
+
+	while( n-- > 0 )
+	    h = ( h ^ (unsigned char)*p++ ) * 16777619u;
+
+	return h;
+}
+
+StatBatch::StatBatch()
+{
+	records = 0;
+	data = new StatBatchData( this );
+}
+
+StatBatch::~StatBatch()
+{
+	delete data;
+}
+
+int
+StatBatch::Fields() const
+{
+	return data->names.Count();
+}
+
+const StrPtr *
+StatBatch::FieldName( int f ) const
+{
+	return f >= 0 && f < data->names.Count() ? data->names.Get( f ) : 0;
+}
+
+int
+StatBatch::FieldId( const StrPtr &name ) const
+{
+	if( data->hash.empty() )
+	    return -1;
+
+	int mask = data->hash.size() - 1;
+	int i = StatBatchHash( name.Text(), name.Length() ) & mask;
+
+	for( ; data->hash[ i ]; i = ( i + 1 ) & mask )
+	{
+	    const StrBuf *n = data->names.Get( data->hash[ i ] - 1 );
+
+	    if( n->Length() == name.Length() &&
+	        !memcmp( n->Text(), name.Text(), name.Length() ) )
+		return data->hash[ i ] - 1;
+	}
+
+	return -1;
+}
+
+int
+StatBatch::Get( int r, int f, StrRef &val ) const
+{
+	if( r < 0 || r >= records || f < 0 || f >= Fields() )
+	    return 0;
+
+	const std::vector< int > &col = data->columns[ f ];
+
+	if( r >= (int)col.size() || col[ r ] < 0 )
+	    return 0;
+
+	const StatBatchEntry &e = data->entries[ col[ r ] ];
+	val.Set( data->text.Text() + e.off, e.len );
+	return 1;
+}
+
+int
+StatBatch::GetVar( int r, int i, StrRef &var, StrRef &val ) const
+{
+	if( r < 0 || r >= records || i < 0 )
+	    return 0;
+
+	int x = data->starts[ r ] + i;
+
+	if( x >= data->starts[ r + 1 ] )
+	    return 0;
+
+	const StatBatchEntry &e = data->entries[ x ];
+	const StrBuf *n = data->names.Get( e.field );
+
+	var.Set( n->Text(), n->Length() );
+	val.Set( data->text.Text() + e.off, e.len );
+	return 1;
+}
+
+StrDict *
+StatBatch::Record( int r )
+{
+	data->record.Set( r );
+	return &data->record;
+}
+
+int
+StatBatch::Intern( const StrPtr &var, int pos )
+{
+	// Records mostly have the same fields in the same order as the
+	// last one, so try the field seen at this position first.
+
+	int f;
+
+	if( pos < (int)data->guess.size() )
+	{
+	    f = data->guess[ pos ];
+	    const StrBuf *n = data->names.Get( f );
+
+	    if( n->Length() == var.Length() &&
+	        !memcmp( n->Text(), var.Text(), var.Length() ) )
+		return f;
+	}
+
+	if( ( f = FieldId( var ) ) < 0 )
+	{
+	    f = data->names.Count();
+	    data->names.Put()->Set( var );
+	    data->columns.push_back( std::vector< int >() );
+
+	    // Keep the table no more than half full.
+
+	    if( 2 * ( f + 1 ) > (int)data->hash.size() )
+	    {
+		int size = data->hash.empty() ? 64 : 2 * data->hash.size();
+		data->hash.assign( size, 0 );
+
+		for( int g = 0; g <= f; g++ )
+		{
+		    const StrBuf *n = data->names.Get( g );
+		    int i = StatBatchHash( n->Text(), n->Length() ) & ( size - 1 );
+		    while( data->hash[ i ] )
+			i = ( i + 1 ) & ( size - 1 );
+		    data->hash[ i ] = g + 1;
+		}
+	    }
+	    else
+	    {
+		int mask = data->hash.size() - 1;
+		int i = StatBatchHash( var.Text(), var.Length() ) & mask;
+		while( data->hash[ i ] )
+		    i = ( i + 1 ) & mask;
+		data->hash[ i ] = f + 1;
+	    }
+	}
+
+	if( pos >= (int)data->guess.size() )
+	    data->guess.resize( pos + 1 );
+
+	data->guess[ pos ] = f;
+	return f;
+}
+
+void
+StatBatch::Add( StrDict *part )
+{
+	int r = records;
+	int pos = data->entries.size() - data->starts[ r ];
+
+	StrRef var, val;
+
+	for( int i = 0; part->GetVar( i, var, val ); i++ )
+	{
+	    int f = Intern( var, pos );
+	    std::vector< int > &col = data->columns[ f ];
+
+	    StatBatchEntry e;
+	    e.field = f;
+	    e.off = data->text.Length();
+	    e.len = val.Length();
+
+	    data->text.Extend( val.Text(), val.Length() );
+	    data->text.Extend( '\0' );
+
+	    // Repeated in this record: just the new value.
+
+	    if( r < (int)col.size() && col[ r ] >= 0 )
+	    {
+		data->entries[ col[ r ] ] = e;
+		continue;
+	    }
+
+	    col.resize( r + 1, -1 );
+	    col[ r ] = data->entries.size();
+	    data->entries.push_back( e );
+	    ++pos;
+	}
+}
+
+void
+StatBatch::End()
+{
+	data->starts.push_back( data->entries.size() );
+	++records;
+}
+
+void
+StatBatch::Clear()
+{
+	// A record still open gets the rest of its fields after this
+	// batch goes out: it becomes the first of the next.
+
+	int open = data->starts[ records ];
+	std::vector< StatBatchEntry > keep( data->entries.begin() + open,
+					    data->entries.end() );
+	StrBuf text;
+
+	for( size_t i = 0; i < keep.size(); i++ )
+	{
+	    const char *v = data->text.Text() + keep[ i ].off;
+	    keep[ i ].off = text.Length();
+	    text.Extend( v, keep[ i ].len );
+	    text.Extend( '\0' );
+	}
+
+	Reset();
+
+	data->text.Set( text );
+	data->entries.swap( keep );
+
+	for( size_t i = 0; i < data->entries.size(); i++ )
+	    data->columns[ data->entries[ i ].field ].assign( 1, i );
+}
+
+void
+StatBatch::Reset()
+{
+	records = 0;
+
+	data->text.Clear();
+	data->entries.clear();
+	data->starts.assign( 1, 0 );
+
+	for( size_t f = 0; f < data->columns.size(); f++ )
+	    data->columns[ f ].clear();
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2024 Perforce Software.  All rights reserved.
+ *
+ * This file is part of Perforce - the FAST SCM System.
+ */
+
+/*
+ * statbatch.h - fstat records, delivered many at a time
+ *
+ * Classes defined:
+ *
+ *	StatBatch - a batch of fstat records, with interned field names
+ *
+ * Public methods:
+ *
+ *	StatBatch::Count() - number of (complete) records in the batch
+ *	StatBatch::Fields() - number of field names seen so far
+ *	StatBatch::FieldName() - the name of field f
+ *	StatBatch::FieldId() - the field number of a name, or -1
+ *	StatBatch::Get() - the value of field f of record r, if it has one
+ *	StatBatch::GetVar() - the i'th field of record r, in arrival order
+ *	StatBatch::Record() - a StrDict of record r, as for OutputStat()
+ *
+ *	StatBatch::Add() - (for the Client) add fields to the open record
+ *	StatBatch::End() - (for the Client) close the open record
+ *	StatBatch::Clear() - (for the Client) empty the batch, but for
+ *		the open record
+ *	StatBatch::Reset() - (for the Client) empty the batch completely
+ *
+ * Notes:
+ *
+ *	A ClientUser whose OutputStatBatchSize() is non-zero gets fstat
+ *	records through OutputStatBatch() instead of OutputStat(), up to
+ *	that many at a time.  Field numbers are kept for the whole
+ *	command, so a caller can look up the fields it wants once and
+ *	then read them column by column with Get().
+ *
+ *	The values are StrRefs into a single buffer held by the batch,
+ *	null terminated, and good until OutputStatBatch() returns.  A
+ *	field repeated within a record (as fstat partials may) keeps its
+ *	first position and takes the last value.
+ */
+
+struct StatBatchData;
+
+class StatBatch {
+
+    public:
+			StatBatch();
+			~StatBatch();
+
+	int		Count() const { return records; }
+	int		Fields() const;
+
+	const StrPtr *	FieldName( int f ) const;
+	int		FieldId( const StrPtr &name ) const;
+
+	int		Get( int r, int f, StrRef &val ) const;
+	int		GetVar( int r, int i, StrRef &var, StrRef &val ) const;
+
+	StrDict *	Record( int r );
+
+	// for the Client
+
+	void		Add( StrDict *part );
+	void		End();
+	void		Clear();
+	void		Reset();
+
+    private:
+
+	int		Intern( const StrPtr &var, int pos );
+
+	int		records;	// complete records
+	StatBatchData	*data;
+} ;
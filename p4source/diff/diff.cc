@@ -98,7 +98,8 @@ Diff::SetInput( FileSys *fx, FileSys *fy, const DiffFlags &flags, Error *e )
 	if( e->Test() )
 	    return;
 
-	diff = new DiffAnalyze( spx, spy, fastMaxD );
+	diff = new DiffAnalyze( spx, spy, fastMaxD, 
+			flags.analysis == DiffFlags::Histogram );
 }
 
 void
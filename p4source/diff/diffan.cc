@@ -343,6 +343,68 @@ DiffAnalyze::FindSnake(
 }
 
 
+/*
+ * DiffAnalyze::AddSnake() - append a matching stretch to the list
+ *
+ * The stretch was matched with ProbablyEqual(); verify actual sequence
+ * contents, splitting it up if there are any pairs of lines which are
+ * ProbablyEqual() but not Equal().
+ */
+
+void
+DiffAnalyze::AddSnake(
+	LineNo x,
+	LineNo y,
+	LineNo u,
+	LineNo v)
+{
+	Snake s;
+
+	s.x=x; s.y=y;
+	s.u=u; s.v=v;
+
+#if DEBUGLEVEL > 1
+	int snakes_added=0;
+	p4debug.printf("SNAKE (%d,%d) to (%d,%d)\n",s.x,s.y,s.u,s.v);
+#endif
+
+	LineNo cx,cy;
+	for(cx=s.x, cy=s.y; cx < s.u ; cx++,cy++) {
+
+	    for(s.x=cx,s.y=cy;cx<s.u && A->Equal(cx,B,cy); cx++,cy++)
+		;
+
+	    if(cx>s.x) { // nonzero length snake to add
+		Snake *toadd = new Snake;
+
+		toadd->next=0;
+		toadd->x=s.x; toadd->y=s.y;
+		toadd->u=cx;  toadd->v=cy;
+
+#if DEBUGLEVEL > 1
+		snakes_added++;
+		p4debug.printf("Adding snake (%d,%d) to (%d,%d)\n",toadd->x,toadd->y,toadd->u,toadd->v);
+#endif
+
+		// add snake to end of linked list
+
+		if(FirstSnake) { 
+		    // already found first one
+		    LastSnake->next=toadd;
+		    LastSnake=toadd;
+		} else {
+		    FirstSnake=LastSnake=toadd;
+		}
+	    }
+	}
+#if DEBUGLEVEL > 1
+	if(snakes_added==0)
+	    p4debug.printf("SNAKE WAS COMPLETELY BOGUS!!!\n");
+	if(snakes_added>1)
+	    p4debug.printf("Snake was broken into %d parts!\n",snakes_added);
+#endif
+}
+
 void 
 DiffAnalyze::LCS(
 	LineNo startx,
@@ -365,64 +427,269 @@ DiffAnalyze::LCS(
 	    LCS(startx,starty,s.x,s.y);
 	}
 
-	if(s.u>s.x) { // snake has nonzero length
+	if(s.u>s.x) // snake has nonzero length
+	    AddSnake(s.x,s.y,s.u,s.v);
 
-#if DEBUGLEVEL > 1
-	    int snakes_added=0;
-	    p4debug.printf("SNAKE (%d,%d) to (%d,%d)\n",s.x,s.y,s.u,s.v);
+	if( endx > s.u && endy > s.v) {
+
+#if DEBUGLEVEL > 0
+	  p4debug.printf("LCS %d , %d , %d , %d\n",s.u,s.v,endx,endy);
+	  if(s.u==startx&&s.v==starty) {
+	      p4debug.printf("INFINITE RECURSION!\n");
+	      abort();
+	  }
 #endif
-	    // verify actual sequence contents, splitting snake up if there 
-	    // are any pairs of lines which are ProbablyEqual() but not Equal()
 
-	    LineNo cx,cy;
-	    for(cx=s.x, cy=s.y; cx < s.u ; cx++,cy++) {
+	  LCS(s.u,s.v,endx,endy);
+      }
+}
 
-		for(s.x=cx,s.y=cy;cx<s.u && A->Equal(cx,B,cy); cx++,cy++)
-		    ;
+/*
+ * Histogram analysis
+ *
+ * An alternative to Myers for the whole of the LCS: rather than the
+ * shortest edit, it looks for the common line that occurs fewest times
+ * in the first file's stretch (ideally once, as patience diff wants),
+ * extends it to the longest run of matching lines around it, takes
+ * that run as a snake and does the same to either side of it.  Runs
+ * of unique lines thus line up the way a reader expects, rather than
+ * matching blank lines and braces across unrelated changes, and the
+ * work is near linear for typical source changes.
+ *
+ * Stretches where each common line occurs more than HIST_MAXCHAIN
+ * times are handed to the Myers LCS(), as are all of them if the
+ * sequence doesn't provide ElementHash().  Work is kept on an explicit
+ * stack so heavily edited files don't recurse deeply.
+ */
 
-		if(cx>s.x) { // nonzero length snake to add
-		    Snake *toadd = new Snake;
+# define HIST_MAXCHAIN	64
 
-		    toadd->next=0;
-		    toadd->x=s.x; toadd->y=s.y;
-		    toadd->u=cx;  toadd->v=cy;
+HistSlot *
+DiffAnalyze::HistLookup( HashVal h )
+{
+	LineNo i = ( h * 2654435761U ) & histMask;
 
-#if DEBUGLEVEL > 1
-		    snakes_added++;
-		    p4debug.printf("Adding snake (%d,%d) to (%d,%d)\n",toadd->x,toadd->y,toadd->u,toadd->v);
-#endif
+	while( histSlots[i].count && histSlots[i].hash != h )
+	    i = ( i + 1 ) & histMask;
 
-		    // add snake to end of linked list
+	return &histSlots[i];
+}
 
-		    if(FirstSnake) { 
-			// already found first one
-			LastSnake->next=toadd;
-			LastSnake=toadd;
-		    } else {
-			FirstSnake=LastSnake=toadd;
-		    }
+/*
+ * DiffAnalyze::HistogramAnchor() - find the snake to split a stretch on
+ *
+ * Returns 1 with s set to the snake, 0 if the stretches have no line
+ * in common, or -1 if all their common lines are too frequent.
+ */
+
+int
+DiffAnalyze::HistogramAnchor(
+	Snake &s,
+	LineNo startx,
+	LineNo starty,
+	LineNo endx,
+	LineNo endy)
+{
+	const LineNo N = endx-startx;
+
+	// Count the first file's lines by hash, chaining occurrences.
+
+	LineNo size = 16;
+	while( size < 2 * N )
+	    size *= 2;
+
+	if( size > histSlotsMax )
+	{
+	    delete []histSlots;
+	    histSlots = new HistSlot[ size ];
+	    histSlotsMax = size;
+	}
+
+	histMask = size - 1;
+
+	if( N > histNextMax )
+	{
+	    delete []histNext;
+	    histNext = new LineNo[ N ];
+	    histNextMax = N;
+	}
+
+	for( LineNo i = 0; i <= histMask; i++ )
+	    histSlots[i].count = 0;
+
+	LineNo x;
+
+	for( x = endx - 1; x >= startx; --x )
+	{
+	    HistSlot *h = HistLookup( A->ElementHash( x ) );
+
+	    if( !h->count )
+		h->hash = A->ElementHash( x );
+
+	    histNext[ x - startx ] = h->count ? h->first : -1;
+	    h->first = x;
+	    ++h->count;
+	}
+
+	// Walk the second file, trying each occurrence of its lines
+	// that are no more frequent than the best found so far.
+
+	LineNo bestCount = HIST_MAXCHAIN;
+	LineNo bestLen = 0;
+	int common = 0;
+
+	for( LineNo y = starty; y < endy; )
+	{
+	    HistSlot *h = HistLookup( B->ElementHash( y ) );
+	    LineNo nexty = y + 1;
+
+	    if( h->count )
+		common = 1;
+
+	    if( h->count && h->count <= bestCount )
+		for( x = h->first; x >= 0; )
+	    {
+		// extend to the whole run of matching lines
+
+		LineNo sx = x, sy = y;
+		LineNo ex = x + 1, ey = y + 1;
+		LineNo count = h->count;
+
+		while( sx > startx && sy > starty && 
+		       A->ProbablyEqual( sx - 1, B, sy - 1 ) )
+		{
+		    --sx, --sy;
+		    LineNo c = HistLookup( A->ElementHash( sx ) )->count;
+		    if( c < count ) count = c;
+		}
+
+		while( ex < endx && ey < endy && 
+		       A->ProbablyEqual( ex, B, ey ) )
+		{
+		    LineNo c = HistLookup( A->ElementHash( ex ) )->count;
+		    if( c < count ) count = c;
+		    ++ex, ++ey;
+		}
+
+		if( count < bestCount || 
+		    ( count == bestCount && ex - sx > bestLen ) )
+		{
+		    s.x = sx; s.y = sy;
+		    s.u = ex; s.v = ey;
+		    bestCount = count;
+		    bestLen = ex - sx;
 		}
+
+		if( ey > nexty )
+		    nexty = ey;
+
+		// skip occurrences inside this run
+
+		while( x >= 0 && x < ex )
+		    x = histNext[ x - startx ];
 	    }
-#if DEBUGLEVEL > 1
-	    if(snakes_added==0)
-		p4debug.printf("SNAKE WAS COMPLETELY BOGUS!!!\n");
-	    if(snakes_added>1)
-		p4debug.printf("Snake was broken into %d parts!\n",snakes_added);
-#endif
+
+	    y = nexty;
 	}
 
-	if( endx > s.u && endy > s.v) {
+	if( bestLen )
+	    return 1;
 
-#if DEBUGLEVEL > 0
-	  p4debug.printf("LCS %d , %d , %d , %d\n",s.u,s.v,endx,endy);
-	  if(s.u==startx&&s.v==starty) {
-	      p4debug.printf("INFINITE RECURSION!\n");
-	      abort();
-	  }
-#endif
+	return common ? -1 : 0;
+}
 
-	  LCS(s.u,s.v,endx,endy);
-      }
+/*
+ * DiffAnalyze::Histogram() - LCS by splitting on rare common lines
+ */
+
+void
+DiffAnalyze::Histogram(
+	LineNo startx,
+	LineNo starty,
+	LineNo endx,
+	LineNo endy)
+{
+	LineNo max = 64;
+	LineNo top = 0;
+	HistRegion *stack = new HistRegion[ max ];
+
+	stack[ top ].x = startx; stack[ top ].u = endx;
+	stack[ top ].y = starty; stack[ top ].v = endy;
+	stack[ top++ ].snake = 0;
+
+	while( top )
+	{
+	    HistRegion r = stack[ --top ];
+
+	    if( r.snake )
+	    {
+		AddSnake( r.x, r.y, r.u, r.v );
+		continue;
+	    }
+
+	    // Everything before r is done, so a common prefix can go
+	    // on the list right away, as can the rest of r if there's
+	    // no anchor to split it on.
+
+	    LineNo x = r.x, y = r.y;
+	    FollowDiagonal( x, y, r.u, r.v );
+
+	    LineNo u = r.u, v = r.v;
+	    FollowReverseDiagonal( u, v, x, y );
+
+	    if( x > r.x )
+		AddSnake( r.x, r.y, x, y );
+
+	    Snake s;
+	    int found = 0;
+
+	    if( x < u && y < v )
+		found = HistogramAnchor( s, x, y, u, v );
+
+	    if( found <= 0 )
+	    {
+		if( found < 0 )
+		    LCS( x, y, u, v );
+
+		if( u < r.u )
+		    AddSnake( u, v, r.u, r.v );
+
+		continue;
+	    }
+
+	    // Push the suffix, the part after the anchor, the anchor
+	    // and the part before it: they're popped in order.
+
+	    if( top + 4 > max )
+	    {
+		HistRegion *old = stack;
+		stack = new HistRegion[ max * 2 ];
+		memcpy( stack, old, top * sizeof( HistRegion ) );
+		delete []old;
+		max *= 2;
+	    }
+
+	    if( u < r.u )
+	    {
+		stack[ top ].x = u; stack[ top ].u = r.u;
+		stack[ top ].y = v; stack[ top ].v = r.v;
+		stack[ top++ ].snake = 1;
+	    }
+
+	    stack[ top ].x = s.u; stack[ top ].u = u;
+	    stack[ top ].y = s.v; stack[ top ].v = v;
+	    stack[ top++ ].snake = 0;
+
+	    stack[ top ].x = s.x; stack[ top ].u = s.u;
+	    stack[ top ].y = s.y; stack[ top ].v = s.v;
+	    stack[ top++ ].snake = 1;
+
+	    stack[ top ].x = x; stack[ top ].u = s.x;
+	    stack[ top ].y = y; stack[ top ].v = s.y;
+	    stack[ top++ ].snake = 0;
+	}
+
+	delete []stack;
 }
 
 /*
@@ -523,11 +790,18 @@ DiffAnalyze::ApplyForwardBias()
 DiffAnalyze::DiffAnalyze(
 	VSequence *fromFile,
 	VSequence *toFile,
-	int fastMaxD )
+	int fastMaxD,
+	int histogram )
 {
 	A = fromFile;
 	B = toFile;
 
+	histSlots = 0;
+	histSlotsMax = 0;
+	histMask = 0;
+	histNext = 0;
+	histNextMax = 0;
+
 	// Calculate a limit on the amount of searching FindSnake does, so as to have
 	// a reasonable upper bound on compute time (and space, although that's less relevant;
 	// it's only 2*maxD elements of length LineNo, i.e. typically 8*maxD bytes).
@@ -592,9 +866,16 @@ DiffAnalyze::DiffAnalyze(
 	// so don't call LCS in this case (this is not just an optimization,
 	// this is necessary for correctness!)
 
-	if(A->Lines() > 0 && B->Lines() > 0)
+	if(A->Lines() > 0 && B->Lines() > 0 && histogram)
+	    Histogram(0, 0, A->Lines(), B->Lines());
+	else if(A->Lines() > 0 && B->Lines() > 0)
 	    LCS(0, 0, A->Lines(), B->Lines());
 
+	delete []histSlots;
+	delete []histNext;
+	histSlots = 0;
+	histNext = 0;
+
 	// Free vectors now that we will not need them anymore
 	fV.Resize( 0 );
 	rV.Resize( 0 );
@@ -13,10 +13,17 @@
  *
  *	DiffAnalyze::AnalyzeDiff( from, to ) - build up difference of files
  *
+ *	By default the LCS is found with Myers' algorithm.  With histogram
+ *	set, the files are instead split around their rarest common lines
+ *	(a "histogram" diff, after patience diff) and Myers is used only on
+ *	stretches where every common line is too frequent to anchor on.
+ *
  * Internal classes:
  *
  *	Snake - a chain of the matching chunks in the files
  *	SymmetricVector - array with index symmetric about 0
+ *	HistSlot - HistogramAnchor()'s count of occurrences of a hash
+ *	HistRegion - a pending piece of Histogram()'s work
  */
 
 class VSequence;
@@ -28,6 +35,18 @@ struct Snake {
 	LineNo 	y,v;	// matching part of second file
 };
 
+struct HistSlot {
+	HashVal	hash;
+	LineNo	count;	// 0 if slot unused
+	LineNo	first;	// first occurrence; later ones via histNext[]
+};
+
+struct HistRegion {
+	LineNo	x,u;	// from first file
+	LineNo	y,v;	// from second file
+	int	snake;	// 1 if x..u matches y..v, else to be diffed
+};
+
 class SymmetricVector {
 
     public:
@@ -57,7 +76,8 @@ class DiffAnalyze {
 
     public:
 
-	DiffAnalyze( VSequence *fromFile, VSequence *toFile, int fastMaxD = 0);
+	DiffAnalyze( VSequence *fromFile, VSequence *toFile, int fastMaxD = 0,
+			int histogram = 0 );
 	~DiffAnalyze();
 
 	VSequence	*GetFromFile() { return A; };
@@ -96,4 +116,24 @@ class DiffAnalyze {
 				LineNo startx, LineNo starty,
 				LineNo endx, LineNo endy );
 
+	void		AddSnake( LineNo x, LineNo y, LineNo u, LineNo v );
+
+	// histogram analysis
+
+	void		Histogram( 
+				LineNo startx, LineNo starty,
+				LineNo endx, LineNo endy );
+
+	int		HistogramAnchor( Snake &s,
+				LineNo startx, LineNo starty,
+				LineNo endx, LineNo endy );
+
+	HistSlot	*HistLookup( HashVal h );
+
+	HistSlot	*histSlots;
+	LineNo		histSlotsMax;
+	LineNo		histMask;
+	LineNo		*histNext;
+	LineNo		histNextMax;
+
 };
@@ -27,6 +27,7 @@ DiffFlags::Init( const char *flags )
 	type = Normal;
 	sequence = Line;
 	grid = Optimal;
+	analysis = Myers;
 	contextCount = 0;
 	int someDigit = 0;
 
@@ -68,6 +69,10 @@ DiffFlags::Init( const char *flags )
 
 	case 't': case 'T':	grid = TwoWay; break;
 
+	// analysis: anchor on rare lines (see diffan.cc)
+
+	case 'p': case 'P':	analysis = Histogram; break;
+
 	// Simple atoi()
 
 	case '0': case '1': case '2': case '3': case '4':
@@ -144,8 +144,9 @@ class DiffFfile : public Sequence {
 class DiffDFile : public DiffAnalyze {
 
     public:
-			DiffDFile( DiffFfile *base, DiffFfile *leg )
-			: DiffAnalyze( base, leg ) 
+			DiffDFile( DiffFfile *base, DiffFfile *leg,
+				int histogram )
+			: DiffAnalyze( base, leg, 0, histogram ) 
 			{ 
 				this->base = base;
 				this->leg = leg;
@@ -272,9 +273,11 @@ DiffMerge::DiffMerge(
 	**  first two diffs.
 	*/
 
-	df1 = new DiffDFile( bf, lf1 );
-	df2 = new DiffDFile( bf, lf2 );
-	df3 = new DiffDFile( lf1, lf2 );
+	int histogram = flags.analysis == DiffFlags::Histogram;
+
+	df1 = new DiffDFile( bf, lf1, histogram );
+	df2 = new DiffDFile( bf, lf2, histogram );
+	df3 = new DiffDFile( lf1, lf2, histogram );
 
 	if( DEBUG_MERGE )
 	{
@@ -218,7 +218,8 @@ MultiMerge::Add( FileSys *f, P4INT64 revId, P4INT64 chgId, Error *e )
 	// Create the diff between last and current sequence,
 	// and walk the snake, merging the new sequence with the chain.
 
-	DiffAnalyze *diff = new DiffAnalyze( fx->s, fy->s );
+	DiffAnalyze *diff = new DiffAnalyze( fx->s, fy->s, 0,
+			flags.analysis == DiffFlags::Histogram );
 	Snake *s = diff->GetSnake();
 	Snake *t;
 
@@ -15,6 +15,7 @@
 # include <strbuf.h>
 # include <filesys.h>
 # include <debug.h>
+# include <tunable.h>
 # include <vararray.h>
 
 # include <readfile.h>
@@ -25,6 +26,14 @@
 
 # include "diffmultimulti.h"
 
+# ifdef HAS_CPP11
+# include <condition_variable>
+# include <deque>
+# include <mutex>
+# include <thread>
+# include <vector>
+# endif
+
 /*
  *   FileMultiMerge - FileSys that lets Diff read a MultiMerge's contents.
  */
@@ -75,6 +84,54 @@ struct MMEntry
 	MultiMerge* m;
 };
 
+/*
+ *   MMCredit - one Credit(): its arguments, and the diff's snakes.
+ */
+
+struct MMCredit
+{
+	MMCredit() { snakes = 0; done = 0; }
+	~MMCredit() { delete []snakes; }
+
+	MultiMerge* srcM;
+	MultiMerge* tgtM;
+	offL_t sRev, eRev, tRev;
+
+	Snake *snakes;	// copy of DiffAnalyze's list
+	Error e;	// from Analyze() on a pool thread
+	int done;	// Analyze() has finished
+};
+
+/*
+ *   MMCreditPool - the threads diffing credits for Credit().
+ *
+ *	The threads take credits from 'todo' and set their 'done'.
+ *	'made' holds them in the order Credit() was called, and only
+ *	the calling thread uses it.
+ */
+
+# ifdef HAS_CPP11
+
+struct MMCreditPool
+{
+	std::mutex		mutex;
+	std::condition_variable	more;	// credits queued, or quit
+	std::condition_variable	done;	// a credit diffed
+
+	std::deque< MMCredit * >	todo;
+	std::deque< MMCredit * >	made;
+	std::vector< std::thread >	threads;
+
+	int			max;	// dm.annotate.threads
+	int			quit;
+};
+
+// Credits made but not yet connected, per thread
+
+# define MM_AHEAD	4
+
+# endif
+
 /*
  *   MultiMultiMerge - a collection of MultiMerges.
  *
@@ -84,10 +141,44 @@ MultiMultiMerge::MultiMultiMerge( StrPtr* diffFlags )
 {
 	multiMerges = new VarArray;
 	flags.Init( diffFlags );
+	pool = 0;
+
+# ifdef HAS_CPP11
+	int threads = p4tunable.Get( P4TUNE_DM_ANNOTATE_THREADS );
+
+	if ( threads > 1 )
+	{
+	    pool = new MMCreditPool;
+	    pool->max = threads;
+	    pool->quit = 0;
+	}
+# endif
 }
 
 MultiMultiMerge::~MultiMultiMerge()
 {
+# ifdef HAS_CPP11
+	if ( pool )
+	{
+	    // Stop the threads before the MultiMerges they read go.
+
+	    {
+		std::lock_guard< std::mutex > lock( pool->mutex );
+		pool->quit = 1;
+	    }
+
+	    pool->more.notify_all();
+
+	    for ( size_t i = 0 ; i < pool->threads.size() ; i++ )
+		pool->threads[i].join();
+
+	    for ( size_t i = 0 ; i < pool->made.size() ; i++ )
+		delete pool->made[i];
+
+	    delete pool;
+	}
+# endif
+
 	MMEntry *m;
 	for ( int i = 0 ; i < multiMerges->Count() ; i++ )
 	{
@@ -101,6 +192,8 @@ MultiMultiMerge::~MultiMultiMerge()
 void
 MultiMultiMerge::Put( const StrPtr &id, MultiMerge *merge )
 {
+	Connected( 0 );
+
 	merge->index = multiMerges->Count();
 
 	MMEntry *m = new MMEntry;
@@ -125,41 +218,209 @@ MultiMultiMerge::Get( const StrPtr &id )
 MultiMerge*
 MultiMultiMerge::Get( int i )
 {
+	Connected( 0 );
+
 	return ((MMEntry *)multiMerges->Get( i ))->m;
 }
 
 const StrPtr&
 MultiMultiMerge::IdOf( MergeLine *line )
 {
+	Connected( 0 );
+
 	return ((MMEntry *)multiMerges->Get( line->merge->index ))->id;
 }
 
 /*
- * MultiMultiMerge::Credit() - This is where the magic happens.  We get
- *	the source and target revs, diff them, and connect them up at
- *	points where it seems likely that the target line came from the
- *	source originally.
+ * MultiMultiMerge::Credit() - diff the source and target revs, and
+ *	connect them up.  With a pool, the diff runs on one of its
+ *	threads, and the lines are connected by a later call.
  */
 
 void
 MultiMultiMerge::Credit( const StrPtr& fromId, offL_t sRev, offL_t eRev,
 			 const StrPtr& toId, offL_t tRev, Error *e )
 {
-	// Set up the diff.
-
 	MultiMerge* srcM = Get( fromId );
 	MultiMerge* tgtM = Get( toId );
 	if ( !srcM || !tgtM )
 	    return;
 
-	FileMultiMerge srcF( srcM, eRev );
-	FileMultiMerge tgtF( tgtM, tRev );
+	MMCredit *c = new MMCredit;
+	c->srcM = srcM;
+	c->tgtM = tgtM;
+	c->sRev = sRev;
+	c->eRev = eRev;
+	c->tRev = tRev;
+
+# ifdef HAS_CPP11
+	if ( pool )
+	{
+	    // Once one has failed, the caller would have stopped.
+
+	    if ( failed.Test() )
+	    {
+		delete c;
+		e->Merge( failed );
+		return;
+	    }
+
+	    {
+		std::lock_guard< std::mutex > lock( pool->mutex );
+
+		pool->todo.push_back( c );
+
+		if ( (int)pool->threads.size() < pool->max )
+		    pool->threads.emplace_back( &MultiMultiMerge::Work, this );
+	    }
+
+	    pool->more.notify_one();
+	    pool->made.push_back( c );
+
+	    // Connect what's ready, and don't get too far ahead.
+
+	    Connected( MM_AHEAD * pool->max );
+
+	    if ( failed.Test() )
+		e->Merge( failed );
+	    return;
+	}
+# endif
+
+	Analyze( c, e );
+
+	if ( !e->Test() )
+	    Connect( c );
+
+	delete c;
+}
+
+/*
+ * MultiMultiMerge::Connected() - connect the pool's diffed credits, in
+ *	the order they were made, until one isn't diffed yet.  Waits for
+ *	the diffs while more than 'keep' credits are left.
+ */
+
+void
+MultiMultiMerge::Connected( int keep )
+{
+# ifdef HAS_CPP11
+	if ( !pool )
+	    return;
+
+	while ( !pool->made.empty() )
+	{
+	    MMCredit *c = pool->made.front();
+
+	    {
+		std::unique_lock< std::mutex > lock( pool->mutex );
+
+		if ( !c->done && (int)pool->made.size() <= keep )
+		    return;
+
+		while ( !c->done )
+		    pool->done.wait( lock );
+	    }
+
+	    pool->made.pop_front();
+
+	    if ( !failed.Test() && c->e.Test() )
+		failed = c->e;
+
+	    if ( !failed.Test() )
+		Connect( c );
+
+	    delete c;
+	}
+# endif
+}
+
+/*
+ * MultiMultiMerge::Work() - a pool thread: diff credits until quit.
+ */
+
+void
+MultiMultiMerge::Work()
+{
+# ifdef HAS_CPP11
+	std::unique_lock< std::mutex > lock( pool->mutex );
+
+	for ( ;; )
+	{
+	    while ( pool->todo.empty() && !pool->quit )
+		pool->more.wait( lock );
+
+	    if ( pool->quit )
+		return;
+
+	    MMCredit *c = pool->todo.front();
+	    pool->todo.pop_front();
+
+	    lock.unlock();
+
+	    Analyze( c, &c->e );
+
+	    lock.lock();
+
+	    c->done = 1;
+	    pool->done.notify_all();
+	}
+# endif
+}
+
+/*
+ * MultiMultiMerge::Analyze() - diff the source and target revs of a
+ *	credit, saving the snakes for Connect().  Safe to call for
+ *	different credits at once: it only reads the MultiMerges.
+ */
+
+void
+MultiMultiMerge::Analyze( MMCredit *c, Error *e )
+{
+	FileMultiMerge srcF( c->srcM, c->eRev );
+	FileMultiMerge tgtF( c->tgtM, c->tRev );
 	Sequence srcS( &srcF, flags, e );
 	Sequence tgtS( &tgtF, flags, e );
 	if ( e->Test() )
 	    return;
 
-	DiffAnalyze diff( &srcS, &tgtS );
+	DiffAnalyze diff( &srcS, &tgtS, 0,
+			flags.analysis == DiffFlags::Histogram );
+
+	// Copy the snakes: they go with the DiffAnalyze.
+
+	int count = 0;
+	Snake *s;
+
+	for ( s = diff.GetSnake() ; s ; s = s->next )
+	    count++;
+
+	c->snakes = new Snake[ count ];
+
+	count = 0;
+	for ( s = diff.GetSnake() ; s ; s = s->next, count++ )
+	{
+	    c->snakes[ count ] = *s;
+	    c->snakes[ count ].next = s->next ? &c->snakes[ count + 1 ] : 0;
+	}
+}
+
+/*
+ * MultiMultiMerge::Connect() - This is where the magic happens.  We have
+ *	diffed the source and target revs, and connect them up at
+ *	points where it seems likely that the target line came from the
+ *	source originally.
+ */
+
+void
+MultiMultiMerge::Connect( MMCredit *c )
+{
+	MultiMerge* srcM = c->srcM;
+	MultiMerge* tgtM = c->tgtM;
+	offL_t sRev = c->sRev;
+
+	FileMultiMerge srcF( srcM, c->eRev );
+	FileMultiMerge tgtF( tgtM, c->tRev );
 
 	// Get ready to walk through the two files.  Note that
 	// the first line is number 0, and that we're
@@ -177,7 +438,7 @@ MultiMultiMerge::Credit( const StrPtr& fromId, offL_t sRev, offL_t eRev,
 	// s->u = end of source common chunk + 1
 	// s->v = end of target common chunk + 1
 
-	for ( s = diff.GetSnake() ; s ; s = s->next )
+	for ( s = c->snakes ; s ; s = s->next )
 	{
 	   // Line source and target up with beginning of snake.
 	   
@@ -228,6 +489,8 @@ MultiMultiMerge::Credit( const StrPtr& fromId, offL_t sRev, offL_t eRev,
 void
 MultiMultiMerge::Dump()
 {
+	Connected( 0 );
+
 	MMEntry *m;
 	for ( int i = 0 ; i < multiMerges->Count() ; i++ )
 	{
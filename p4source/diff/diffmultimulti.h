@@ -25,6 +25,13 @@
  * to the source at some point within the source rev range are considered to
  * have been merged into the target as a result of that integration.
  *
+ * When dm.annotate.threads is above 1, Credit() hands its diff to a pool
+ * of up to that many threads and returns.  The lines are connected by the
+ * calling thread, in the order Credit() was called, so the result is the
+ * same as with a single thread.  Put(), Get(), IdOf() and Dump() first
+ * wait for the credits already made.  A credit that fails is reported by
+ * the next Credit(), and those made after it are dropped.
+ *
  * Classes defined:
  *	MultiMultiMerge - the multiple MultiMerge merger
  *                        (try saying that three times fast)
@@ -33,6 +40,8 @@
  */
 
 struct MergeLine;
+struct MMCredit;
+struct MMCreditPool;
 class MultiMerge;
 class VarArray;
 
@@ -55,7 +64,15 @@ class MultiMultiMerge
 
 	MultiMerge*	Get( const StrPtr& id );
 
+	void		Analyze( MMCredit *c, Error *e );
+	void		Connect( MMCredit *c );
+	void		Connected( int keep );
+	void		Work();
+
 	VarArray*	multiMerges;
 	DiffFlags	flags;
 
+	MMCreditPool*	pool;
+	Error		failed;
+
 };
@@ -0,0 +1,358 @@
+/*
+ * Copyright 2024 Perforce Software.  All rights reserved.
+ *
+ * This file is part of Perforce - the FAST SCM System.
+ */
+
+# define NEED_TYPES
+
+#include <stdhdrs.h>
+#include <error.h>
+#include <strbuf.h>
+#include <readfile.h>
+
+#include "diffsp.h"
+#include "diffscan.h"
+
+/*
+ * diffscan.cc -- bulk scanning and hashing for diff's Sequencers
+ */
+
+# if defined( __x86_64__ ) || defined( _M_X64 )
+# define DIFFSCAN_SSE2
+# include <emmintrin.h>
+# if defined( __GNUC__ ) || defined( __clang__ )
+# define DIFFSCAN_AVX2
+# include <immintrin.h>
+# endif
+# elif defined( __aarch64__ ) || defined( _M_ARM64 )
+# define DIFFSCAN_NEON
+# include <arm_neon.h>
+# endif
+
+/*
+ * HashPowers - 293^k (mod 2^32), for folding k characters at once
+ *
+ *	pow[k] is 293^k; the characters of a block of k are multiplied
+ *	by pow[k-1] down to pow[0] and the running hash by pow[k].
+ */
+
+struct HashPowers {
+
+			HashPowers()
+			{
+			    pow[0] = 1;
+			    for( int i = 1; i <= 32; i++ )
+				pow[i] = pow[i-1] * 293;
+			}
+
+	HashVal		pow[33];
+
+} ;
+
+static const HashPowers powers;
+
+/*
+ * LowBit() - index of the lowest set bit of a nonzero mask
+ */
+
+static inline int
+LowBit( unsigned long long m )
+{
+# if defined( __GNUC__ ) || defined( __clang__ )
+	return __builtin_ctzll( m );
+# else
+	int i = 0;
+	while( !( m & 1 ) )
+	    m >>= 1, ++i;
+	return i;
+# endif
+}
+
+/*
+ * Scalar versions, also used for the tails of the vector versions
+ */
+
+static HashVal
+HashScalar( HashVal h, const unsigned char *p, int n )
+{
+	const HashVal *w = powers.pow;
+
+	for( ; n >= 4; p += 4, n -= 4 )
+	    h = h * w[4] + p[0] * w[3] + p[1] * w[2] + p[2] * w[1] + p[3];
+
+	for( ; n > 0; --n )
+	    h = 293 * h + *p++;
+
+	return h;
+}
+
+static inline int
+ScanScalar( const unsigned char *p, int i, int n, int white )
+{
+	for( ; i < n; i++ )
+	{
+	    unsigned char c = p[i];
+
+	    if( c == '\n' || c == '\r' ||
+		( white && ( c == ' ' || c == '\t' ) ) )
+		break;
+	}
+
+	return i;
+}
+
+# ifdef DIFFSCAN_SSE2
+
+static int
+ScanSse2( const unsigned char *p, int n, int white )
+{
+	const __m128i lf = _mm_set1_epi8( '\n' );
+	const __m128i cr = _mm_set1_epi8( '\r' );
+	const __m128i sp = _mm_set1_epi8( white ? ' ' : '\n' );
+	const __m128i tb = _mm_set1_epi8( white ? '\t' : '\n' );
+
+	int i = 0;
+
+	for( ; i + 16 <= n; i += 16 )
+	{
+	    __m128i v = _mm_loadu_si128( (const __m128i *)( p + i ) );
+
+	    __m128i m = _mm_or_si128(
+		_mm_or_si128( _mm_cmpeq_epi8( v, lf ), _mm_cmpeq_epi8( v, cr ) ),
+		_mm_or_si128( _mm_cmpeq_epi8( v, sp ), _mm_cmpeq_epi8( v, tb ) ) );
+
+	    unsigned bits = _mm_movemask_epi8( m );
+
+	    if( bits )
+		return i + LowBit( bits );
+	}
+
+	return ScanScalar( p, i, n, white );
+}
+
+# endif
+
+# ifdef DIFFSCAN_AVX2
+
+__attribute__(( target( "avx2" ) ))
+static int
+ScanAvx2( const unsigned char *p, int n, int white )
+{
+	const __m256i lf = _mm256_set1_epi8( '\n' );
+	const __m256i cr = _mm256_set1_epi8( '\r' );
+	const __m256i sp = _mm256_set1_epi8( white ? ' ' : '\n' );
+	const __m256i tb = _mm256_set1_epi8( white ? '\t' : '\n' );
+
+	int i = 0;
+
+	for( ; i + 32 <= n; i += 32 )
+	{
+	    __m256i v = _mm256_loadu_si256( (const __m256i *)( p + i ) );
+
+	    __m256i m = _mm256_or_si256(
+		_mm256_or_si256( _mm256_cmpeq_epi8( v, lf ),
+				 _mm256_cmpeq_epi8( v, cr ) ),
+		_mm256_or_si256( _mm256_cmpeq_epi8( v, sp ),
+				 _mm256_cmpeq_epi8( v, tb ) ) );
+
+	    unsigned bits = (unsigned)_mm256_movemask_epi8( m );
+
+	    if( bits )
+		return i + LowBit( bits );
+	}
+
+	return i + ScanSse2( p + i, n - i, white );
+}
+
+/*
+ * HashAvx2() - 32 characters per step: widen each quarter to eight
+ * 32 bit lanes, multiply by its slice of 293^31..293^0, and sum.
+ */
+
+__attribute__(( target( "avx2" ) ))
+static HashVal
+HashAvx2( HashVal h, const unsigned char *p, int n )
+{
+	if( n < 32 )
+	    return HashScalar( h, p, n );
+
+	const HashVal *pw = powers.pow;
+
+	const __m256i w0 = _mm256_setr_epi32(
+		pw[31], pw[30], pw[29], pw[28], pw[27], pw[26], pw[25], pw[24] );
+	const __m256i w1 = _mm256_setr_epi32(
+		pw[23], pw[22], pw[21], pw[20], pw[19], pw[18], pw[17], pw[16] );
+	const __m256i w2 = _mm256_setr_epi32(
+		pw[15], pw[14], pw[13], pw[12], pw[11], pw[10], pw[9], pw[8] );
+	const __m256i w3 = _mm256_setr_epi32(
+		pw[7], pw[6], pw[5], pw[4], pw[3], pw[2], pw[1], pw[0] );
+
+	for( ; n >= 32; p += 32, n -= 32 )
+	{
+	    __m256i c0 = _mm256_cvtepu8_epi32(
+		_mm_loadl_epi64( (const __m128i *)( p ) ) );
+	    __m256i c1 = _mm256_cvtepu8_epi32(
+		_mm_loadl_epi64( (const __m128i *)( p + 8 ) ) );
+	    __m256i c2 = _mm256_cvtepu8_epi32(
+		_mm_loadl_epi64( (const __m128i *)( p + 16 ) ) );
+	    __m256i c3 = _mm256_cvtepu8_epi32(
+		_mm_loadl_epi64( (const __m128i *)( p + 24 ) ) );
+
+	    __m256i s = _mm256_add_epi32(
+		_mm256_add_epi32( _mm256_mullo_epi32( c0, w0 ),
+				  _mm256_mullo_epi32( c1, w1 ) ),
+		_mm256_add_epi32( _mm256_mullo_epi32( c2, w2 ),
+				  _mm256_mullo_epi32( c3, w3 ) ) );
+
+	    __m128i x = _mm_add_epi32( _mm256_castsi256_si128( s ),
+				       _mm256_extracti128_si256( s, 1 ) );
+	    x = _mm_add_epi32( x, _mm_shuffle_epi32( x, 0x4e ) );
+	    x = _mm_add_epi32( x, _mm_shuffle_epi32( x, 0xb1 ) );
+
+	    h = h * pw[32] + (HashVal)_mm_cvtsi128_si32( x );
+	}
+
+	return HashScalar( h, p, n );
+}
+
+/*
+ * HaveAvx2() - ask the CPU once; a racing first call just asks twice
+ */
+
+static int
+HaveAvx2()
+{
+	static int have = -1;
+
+	if( have < 0 )
+	{
+	    __builtin_cpu_init();
+	    have = __builtin_cpu_supports( "avx2" ) ? 1 : 0;
+	}
+
+	return have;
+}
+
+# endif
+
+# ifdef DIFFSCAN_NEON
+
+static int
+ScanNeon( const unsigned char *p, int n, int white )
+{
+	const uint8x16_t lf = vdupq_n_u8( '\n' );
+	const uint8x16_t cr = vdupq_n_u8( '\r' );
+	const uint8x16_t sp = vdupq_n_u8( white ? ' ' : '\n' );
+	const uint8x16_t tb = vdupq_n_u8( white ? '\t' : '\n' );
+
+	int i = 0;
+
+	for( ; i + 16 <= n; i += 16 )
+	{
+	    uint8x16_t v = vld1q_u8( p + i );
+
+	    uint8x16_t m = vorrq_u8(
+		vorrq_u8( vceqq_u8( v, lf ), vceqq_u8( v, cr ) ),
+		vorrq_u8( vceqq_u8( v, sp ), vceqq_u8( v, tb ) ) );
+
+	    // Narrow to 4 bits per byte to get a scalar mask
+
+	    uint64_t bits = vget_lane_u64( vreinterpret_u64_u8(
+		vshrn_n_u16( vreinterpretq_u16_u8( m ), 4 ) ), 0 );
+
+	    if( bits )
+		return i + ( LowBit( bits ) >> 2 );
+	}
+
+	return ScanScalar( p, i, n, white );
+}
+
+/*
+ * HashNeon() - 16 characters per step, as HashAvx2() does 32.
+ */
+
+static HashVal
+HashNeon( HashVal h, const unsigned char *p, int n )
+{
+	if( n < 16 )
+	    return HashScalar( h, p, n );
+
+	const HashVal *pw = powers.pow;
+
+	const HashVal t0[4] = { pw[15], pw[14], pw[13], pw[12] };
+	const HashVal t1[4] = { pw[11], pw[10], pw[9], pw[8] };
+	const HashVal t2[4] = { pw[7], pw[6], pw[5], pw[4] };
+	const HashVal t3[4] = { pw[3], pw[2], pw[1], pw[0] };
+
+	const uint32x4_t w0 = vld1q_u32( t0 );
+	const uint32x4_t w1 = vld1q_u32( t1 );
+	const uint32x4_t w2 = vld1q_u32( t2 );
+	const uint32x4_t w3 = vld1q_u32( t3 );
+
+	for( ; n >= 16; p += 16, n -= 16 )
+	{
+	    uint8x16_t v = vld1q_u8( p );
+	    uint16x8_t lo = vmovl_u8( vget_low_u8( v ) );
+	    uint16x8_t hi = vmovl_u8( vget_high_u8( v ) );
+
+	    uint32x4_t s = vmulq_u32( vmovl_u16( vget_low_u16( lo ) ), w0 );
+	    s = vmlaq_u32( s, vmovl_u16( vget_high_u16( lo ) ), w1 );
+	    s = vmlaq_u32( s, vmovl_u16( vget_low_u16( hi ) ), w2 );
+	    s = vmlaq_u32( s, vmovl_u16( vget_high_u16( hi ) ), w3 );
+
+	    h = h * pw[16] + vaddvq_u32( s );
+	}
+
+	return HashScalar( h, p, n );
+}
+
+# endif
+
+/*
+ * DiffHashRun() - CHARHASH() a run of characters into a hash
+ */
+
+HashVal
+DiffHashRun( HashVal h, const unsigned char *p, int n )
+{
+# if defined( DIFFSCAN_AVX2 )
+	if( HaveAvx2() )
+	    return HashAvx2( h, p, n );
+# elif defined( DIFFSCAN_NEON )
+	return HashNeon( h, p, n );
+# endif
+	return HashScalar( h, p, n );
+}
+
+/*
+ * DiffScanEol()/DiffScanWhite() - find the first line end (or blank)
+ */
+
+static inline int
+DiffScan( const unsigned char *p, int n, int white )
+{
+# if defined( DIFFSCAN_AVX2 )
+	if( HaveAvx2() )
+	    return ScanAvx2( p, n, white );
+# endif
+# if defined( DIFFSCAN_SSE2 )
+	return ScanSse2( p, n, white );
+# elif defined( DIFFSCAN_NEON )
+	return ScanNeon( p, n, white );
+# else
+	return ScanScalar( p, 0, n, white );
+# endif
+}
+
+int
+DiffScanEol( const unsigned char *p, int n )
+{
+	return DiffScan( p, n, 0 );
+}
+
+int
+DiffScanWhite( const unsigned char *p, int n )
+{
+	return DiffScan( p, n, 1 );
+}
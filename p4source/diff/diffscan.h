@@ -0,0 +1,32 @@
+/*
+ * Copyright 2024 Perforce Software.  All rights reserved.
+ *
+ * This file is part of Perforce - the FAST SCM System.
+ */
+
+/*
+ * diffscan.h -- bulk scanning and hashing for diff's Sequencers
+ *
+ * Functions defined:
+ *
+ *	DiffHashRun() - CHARHASH() a run of characters into a hash
+ *	DiffScanEol() - find the first '\r' or '\n' in a run
+ *	DiffScanWhite() - find the first ' ', '\t', '\r' or '\n' in a run
+ *
+ * Notes:
+ *
+ *	DiffHashRun( h, p, n ) returns exactly what applying CHARHASH()
+ *	to each of the n characters at p in turn would: the hash is an
+ *	unsigned (mod 2^32) polynomial, so runs are folded several
+ *	characters at a time.
+ *
+ *	The scans return the index of the character found, or n if none.
+ *
+ *	On x86_64 the scans use SSE2 and, where the CPU has it, the
+ *	scans and hashing use AVX2; on aarch64 both use NEON.  Other
+ *	platforms get the unrolled scalar code.
+ */
+
+HashVal	DiffHashRun( HashVal h, const unsigned char *p, int n );
+int	DiffScanEol( const unsigned char *p, int n );
+int	DiffScanWhite( const unsigned char *p, int n );
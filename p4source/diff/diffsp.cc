@@ -13,6 +13,8 @@
 #include <stdhdrs.h>
 #include <error.h>
 #include <strbuf.h>
+#include <debug.h>
+#include <tunable.h>
 #include <readfile.h>
 
 #include "diff.h"
@@ -61,6 +63,12 @@ Sequence::Sequence( FileSys *f, const DiffFlags &flags, Error *e )
 	if( e->Test() )
 	    return;
 
+	// Equal() seeks back to lines all over both files: if the file
+	// couldn't be mapped (e.g. it is translated), hold it in memory
+	// anyway, within the same limit as mapping.
+
+	readfile->Preload( p4tunable.Get( P4TUNE_FILESYS_MAXMAP ) );
+
 	// allocate initial space
 
 	GrowLineBuf( e ); 
@@ -24,6 +24,9 @@
  *
  * Sequence relies on ReadFile's ability to handle text files of different
  * line endings, and thus takes a LineType flag for CopyLines() and Dump().
+ * Files up to filesys.maxmap are held in memory (mapped or preloaded),
+ * so the seeking done by Equal() is just pointer arithmetic; bigger
+ * files are streamed through ReadFile's window.
  *
  * Classes defined:
  *
@@ -105,6 +108,12 @@ class VSequence {
 	virtual LineNo	Lines() const = 0;
 	virtual int	Equal( LineNo lA, VSequence *B, LineNo lB ) = 0;
 	virtual int	ProbablyEqual( LineNo lA, VSequence *B, LineNo lB ) =0;
+
+	// A hash that's equal for ProbablyEqual() elements, for grouping
+	// them (DiffAnalyze's histogram analysis).  The default makes all
+	// elements alike, which leaves that analysis to fall back to Myers.
+
+	virtual HashVal	ElementHash( LineNo ) const { return 0; }
 };
 
 /*
@@ -142,6 +151,8 @@ class Sequence : public VSequence {
 			    return Hash( lA ) == ((Sequence*)B)->Hash( lB );
 			}
 
+	HashVal		ElementHash( LineNo l ) const { return Hash( l ); }
+
 	void 		StoreLine( HashVal HashValue, Error *e );
 
     private:
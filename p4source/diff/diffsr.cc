@@ -15,6 +15,7 @@
 
 #include "diffsp.h"
 #include "diffsr.h"
+#include "diffscan.h"
 
 # if USE_CR
 # define NEWLINE '\r'
@@ -59,32 +60,43 @@
  * Previous implementation thought we had chars if
  * h != 0, but that didn't handle a null-only tail
  * of a file.
+ *
+ * Each line (or the part of it in the ReadFile's window) is
+ * found with memchr() and hashed as a run by DiffHashRun().
  */
 
 void 
 LineReader::Load( Error *e )
 {
 	HashVal h = 0;
+	int inLine = 0;
+	int l;
 
-	if( !src->Eof() ) 
-	    while( !e->Test() )
+	while( !e->Test() && ( l = src->Avail() ) )
 	{
-	    UChar c = src->Char();
-	    src->Next();
+	    const unsigned char *p = src->Ptr();
+	    const unsigned char *nl = 
+		(const unsigned char *)memchr( p, NEWLINE, l );
 
-	    h = CHARHASH(h, c);
+	    int n = nl ? nl - p + 1 : l;
 
-	    if( src->Eof() )
+	    h = DiffHashRun( h, p, n );
+	    src->Skip( n );
+
+	    if( nl )
 	    {
 		A->StoreLine( h, e );
-		break;
+		h = 0;
+		inLine = 0;
 	    }
-	    else if( c == NEWLINE )
+	    else
 	    {
-		A->StoreLine( h, e );
-		h = 0;
+		inLine = 1;
 	    }
 	}
+
+	if( inLine && !e->Test() )
+	    A->StoreLine( h, e );
 }
 
 /*
@@ -214,6 +226,35 @@ WClassReader::Load( Error *e )
  * Ignores line ending,  treat "\r\n" same as "\n" and "\r"
  */
 
+/*
+ * DifflReader::Run() - hash a run of plain characters in bulk
+ *
+ * Hashes the characters in the window up to the first that 'scan'
+ * finds (line ends, or whitespace too), leaving that character --
+ * or, if there's none, the last in the window -- for the Load()
+ * loops to handle one at a time.  The characters skipped are thus
+ * never special nor the last in the file, and for those the Load()
+ * loops do nothing but CHARHASH() them.
+ */
+
+void
+DifflReader::Run( HashVal &h, int (*scan)( const unsigned char *, int ) )
+{
+	int l = src->Avail();
+	const unsigned char *p = src->Ptr();
+
+	int n = (*scan)( p, l );
+
+	if( n == l )
+	    --n;
+
+	if( n > 0 )
+	{
+	    h = DiffHashRun( h, p, n );
+	    src->Skip( n );
+	}
+}
+
 /*
  * DifflReader::Load() - hash lines
  */
@@ -225,6 +266,8 @@ DifflReader::Load( Error *e )
 
 	while( !src->Eof() && !e->Test() )
 	{
+	    Run( h, DiffScanEol );
+
 	    UChar c = src->Char();
 	    src->Next();
 
@@ -320,6 +363,8 @@ DiffbReader::Load( Error *e )
 
 	while( !src->Eof() && !e->Test() ) 
 	{
+	    Run( h, DiffScanWhite );
+
 	    UChar c = src->Char();
 	    src->Next();
 
@@ -444,6 +489,8 @@ DiffwReader::Load( Error *e )
 
 	while( !src->Eof() && !e->Test() ) 
 	{
+	    Run( h, DiffScanWhite );
+
 	    UChar c = src->Char();
 	    src->Next();
 
@@ -47,6 +47,11 @@ class DifflReader : public Sequencer {
 
 	int		NewLine( UChar c ) { return c == '\r' || c == '\n'; }
 	int		testEndEOL;
+
+	// hash the plain characters ahead of the next one 'scan' finds
+
+	void		Run( HashVal &h, 
+				int (*scan)( const unsigned char *, int ) );
 } ;
 
 class DiffbReader : public DifflReader {
@@ -19,6 +19,7 @@
 #include "i18napi.h"
 #include "charcvt.h"
 #include "charman.h"
+#include "charscan.h"
 
 CharSetCvt::~CharSetCvt()
 {
@@ -580,6 +581,49 @@ CharSetCvtFromUTF8::IgnoreBOM()
 	checkBOM = 1;
 }
 
+/*
+ * CharSetCvt::CopyAscii() - copy a run of 7-bit characters unchanged
+ *
+ * For converters that pass ASCII straight through: copies as much of
+ * the run at the source as fits in the target, counting lines and
+ * characters as the converters do, and returns how much it copied.
+ * Unless 'del' is set, DEL (0x7f) ends the run.
+ */
+
+int
+CharSetCvt::CopyAscii(const char **sourcestart, const char *sourceend,
+		      char **targetstart, char *targetend, int del)
+{
+	int n = sourceend - *sourcestart;
+
+	if (targetend - *targetstart < n)
+	    n = targetend - *targetstart;
+
+	n = CharScanAscii((const unsigned char *)*sourcestart, n, del);
+
+	if (!n)
+	    return 0;
+
+	memcpy(*targetstart, *sourcestart, n);
+
+	const char *p = *sourcestart;
+	const char *e = p + n;
+	const char *nl = 0;
+
+	while ((p = (const char *)memchr(p, '\n', e - p)))
+	{
+	    ++linecnt;
+	    nl = p++;
+	}
+
+	charcnt = nl ? e - nl - 1 : charcnt + n;
+
+	*sourcestart += n;
+	*targetstart += n;
+
+	return n;
+}
+
 unsigned short
 CharSetCvt::MapThru(unsigned short v,
 		   const CharSetCvt::MapEnt *m,
@@ -602,3 +646,73 @@ CharSetCvt::MapThru(unsigned short v,
 
 	return d;
 }
+
+CharSetCvt::MapIndex::~MapIndex()
+{
+	delete [] (char *)(unsigned short **)pages;
+}
+
+unsigned short **
+CharSetCvt::MapIndex::Build()
+{
+	// Which pages does the table use?
+
+	char used[ 256 ];
+	int npages = 1;
+
+	memset( used, 0, sizeof( used ) );
+
+	for( int i = 0; i < count; i++ )
+	    if( !used[ map[i].cfrom >> 8 ] )
+	    {
+		used[ map[i].cfrom >> 8 ] = 1;
+		++npages;
+	    }
+
+	// One block: the page pointers, the default page, then the
+	// pages used.
+
+	unsigned short **p = (unsigned short **)new char[
+		256 * sizeof( *p ) + npages * 256 * sizeof( **p ) ];
+
+	unsigned short *none = (unsigned short *)( p + 256 );
+	unsigned short *next = none + 256;
+
+	for( int l = 0; l < 256; l++ )
+	    none[l] = defval;
+
+	for( int h = 0; h < 256; h++ )
+	{
+	    if( !used[h] )
+	    {
+		p[h] = none;
+		continue;
+	    }
+
+	    // Fill from MapThru() itself, so the answers can't differ.
+
+	    p[h] = next;
+
+	    for( int l = 0; l < 256; l++ )
+		next[l] = MapThru( ( h << 8 ) | l, map, count, defval );
+
+	    next += 256;
+	}
+
+	// Threads racing to build keep the first block published.
+
+# ifdef HAS_CPP11
+	unsigned short **built = 0;
+
+	if( !pages.compare_exchange_strong( built, p,
+		std::memory_order_acq_rel, std::memory_order_acquire ) )
+	{
+	    delete [] (char *)p;
+	    p = built;
+	}
+# else
+	pages = p;
+# endif
+
+	return p;
+}
@@ -400,6 +400,16 @@ CharSetCvtUTF8toShiftJis::Cvt(const char **sourcestart, const char *sourceend,
 	while (*sourcestart < sourceend && *targetstart < targetend)
 	{
 	    v = **sourcestart & 0xff;
+
+#ifndef UNICODEMAPPING
+	    if (!(v & 0x80) &&
+		CopyAscii(sourcestart, sourceend, targetstart, targetend))
+	    {
+		checkBOM = 0;
+		continue;
+	    }
+#endif
+
 	    int l;
 	    if (v & 0x80)
 	    {
@@ -428,7 +438,7 @@ CharSetCvtUTF8toShiftJis::Cvt(const char **sourcestart, const char *sourceend,
 		    }
 # endif
 		    // at this point v is UCS 2
-		    newv = MapThru(v, UCS2toShiftJis, MapCount(), 0xfffd);
+		    newv = UCS2toShiftJisIndex.Map(v);
 		    if (newv != 0xfffd)
 		    {
 		    emitit:		    
@@ -511,6 +521,13 @@ CharSetCvtShiftJistoUTF8::Cvt(const char **sourcestart, const char *sourceend,
     while (*sourcestart < sourceend && *targetstart < targetend)
     {
 	v = **sourcestart & 0xff;
+
+#ifndef UNICODEMAPPING
+	if (!(v & 0x80) &&
+	    CopyAscii(sourcestart, sourceend, targetstart, targetend))
+	    continue;
+#endif
+
 	int l = 0;
 	if ((v & 0x80) && (v < 0xa1 || v >= 0xe0))
 	{
@@ -525,7 +542,7 @@ CharSetCvtShiftJistoUTF8::Cvt(const char **sourcestart, const char *sourceend,
 	}
 	oldv = v;
 	if (v > 0x20)
-	    v = MapThru(v, ShiftJistoUCS2, MapCount(), 0xfffd);
+	    v = ShiftJistoUCS2Index.Map(v);
 	if (v == 0xfffd)
 	{
 	    int upper, lower;
@@ -627,6 +644,15 @@ CharSetCvtUTF8toEUCJP::Cvt(const char **sourcestart, const char *sourceend,
 	{
 	    v = **sourcestart & 0xff;
 
+# ifndef UNICODE_MAPPING
+	    if (!(v & 0x80) &&
+		CopyAscii(sourcestart, sourceend, targetstart, targetend, 0))
+	    {
+		checkBOM = 0;
+		continue;
+	    }
+# endif
+
 	    int l = 0; // extra characters expected
 	    int t = 2; // characters output
 	
@@ -659,7 +685,7 @@ CharSetCvtUTF8toEUCJP::Cvt(const char **sourcestart, const char *sourceend,
 		    // at this point v is UCS 2
 		case 0:
 		    oldv = v;
-		    v = MapThru(v, UCS2toEUCJP, MapCount(), 0xfffd);
+		    v = UCS2toEUCJPIndex.Map(v);
 		    if (v == 0xfffd && oldv >= 0xe000 && oldv <= 0xe757)
 		    {
 			// user defined character
@@ -741,6 +767,12 @@ CharSetCvtEUCJPtoUTF8::Cvt(const char **sourcestart, const char *sourceend,
 	{
 	    v = **sourcestart & 0xff;
 
+# ifndef UNICODE_MAPPING
+	    if (!(v & 0x80) &&
+		CopyAscii(sourcestart, sourceend, targetstart, targetend, 0))
+		continue;
+# endif
+
 	    int l = 0; // extra characters expected
 	    int c = 0; // code set detection (0-3)
 
@@ -771,7 +803,7 @@ CharSetCvtEUCJPtoUTF8::Cvt(const char **sourcestart, const char *sourceend,
 	    }
 	    oldv = v;
 	    if ( v > 0x20 )
-		v = MapThru(v, EUCJPtoUCS2, MapCount(), 0xfffd);
+		v = EUCJPtoUCS2Index.Map(v);
 	    if (v == 0xfffd)
 	    {
 		// check for user-defined character
@@ -965,6 +997,14 @@ CharSetCvtUTF8toCp::Cvt(const char **sourcestart, const char *sourceend,
 	while (*sourcestart < sourceend && *targetstart < targetend)
 	{
 	    v = **sourcestart & 0xff;
+
+	    if (!(v & 0x80) &&
+		CopyAscii(sourcestart, sourceend, targetstart, targetend))
+	    {
+		checkBOM = 0;
+		continue;
+	    }
+
 	    int l;
 	    if (v & 0x80)
 	    {
@@ -993,7 +1033,7 @@ CharSetCvtUTF8toCp::Cvt(const char **sourcestart, const char *sourceend,
 		    }
 # endif
 		    // at this point v is UCS 2
-		    newv = MapThru(v, toMap, toMapSize, 0xfffd);
+		    newv = toIndex->Map(v);
 		    if (newv != 0xfffd)
 		    {
 			if (newv > 0xff)
@@ -1102,6 +1142,11 @@ CharSetCvtCptoUTF8::Cvt(const char **sourcestart, const char *sourceend,
     while (*sourcestart < sourceend && *targetstart < targetend)
     {
 	v = **sourcestart & 0xff;
+
+	if (!(v & 0x80) &&
+	    CopyAscii(sourcestart, sourceend, targetstart, targetend))
+	    continue;
+
 	int l = 0;
 	if ( isDoubleByte( v ) )
 	{
@@ -1115,7 +1160,7 @@ CharSetCvtCptoUTF8::Cvt(const char **sourcestart, const char *sourceend,
 	    v |= *++*sourcestart & 0xff;
 	}
 	if (v > 0x7f)
-	    v = MapThru(v, toMap, toMapSize, 0xfffd);
+	    v = toIndex->Map(v);
 	if (v == 0xfffd)
 	{
 	    lasterr = NOMAPPING;
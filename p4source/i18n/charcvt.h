@@ -11,6 +11,10 @@ class StrBuf;
 class StrDict;
 class CharSetCvtCache;
 
+# ifdef HAS_CPP11
+# include <atomic>
+# endif
+
 /*
  * CharSetCvt.h - Character set converters
  */
@@ -65,6 +69,50 @@ public:
 	unsigned short cfrom, cto;
     };
 
+    /*
+     * MapIndex - direct lookup into a MapEnt table
+     *
+     * Map() answers as MapThru() would, with two loads (the page for
+     * the high byte, then the entry for the low byte) in place of a
+     * binary search.  The pages are built on first use: one for each
+     * 256 values the table maps any of, and one of the default value
+     * shared by the rest.
+     */
+
+    class MapIndex {
+    public:
+	MapIndex( const MapEnt *m, int n, unsigned short d )
+	    : map( m ), count( n ), defval( d ), pages( 0 ) {}
+	~MapIndex();
+
+	unsigned short Map( unsigned short v )
+	{
+# ifdef HAS_CPP11
+	    unsigned short **p = pages.load( std::memory_order_acquire );
+# else
+	    unsigned short **p = pages;
+# endif
+	    if( !p )
+		p = Build();
+	    return p[ v >> 8 ][ v & 0xff ];
+	}
+
+    private:
+	unsigned short **Build();
+
+	const MapEnt *map;
+	int count;
+	unsigned short defval;
+# ifdef HAS_CPP11
+	std::atomic< unsigned short ** > pages;
+# else
+	unsigned short **pages;
+# endif
+
+	MapIndex(const MapIndex &);		// to prevent copys
+	void operator =(const MapIndex &);	// to prevent assignment
+    };
+
     static char bytesFromUTF8[];
     static unsigned long offsetsFromUTF8[];
     static unsigned long minimumFromUTF8[];
@@ -87,6 +135,9 @@ protected:
 
     static unsigned short MapThru( unsigned short, const MapEnt *,
 		int, unsigned short );
+
+    int CopyAscii( const char **sourcestart, const char *sourceend,
+		   char **targetstart, char *targetend, int del = 1 );
 private:
     char *fastbuf;
     int fastsize;
@@ -240,6 +291,7 @@ class CharSetCvtUTF8toShiftJis : public CharSetCvtFromUTF8 {
 
 private:
     static MapEnt UCS2toShiftJis[];
+    static MapIndex UCS2toShiftJisIndex;
 
     friend void verifymaps();
     friend void dumpmaps();
@@ -263,6 +315,7 @@ class CharSetCvtShiftJistoUTF8 : public CharSetCvt {
 
 private:
     static MapEnt ShiftJistoUCS2[];
+    static MapIndex ShiftJistoUCS2Index;
 
     friend void verifymaps();
     friend void dumpmaps();
@@ -284,6 +337,7 @@ class CharSetCvtUTF8toEUCJP : public CharSetCvtFromUTF8 {
 
 private:
     static MapEnt UCS2toEUCJP[];
+    static MapIndex UCS2toEUCJPIndex;
 
     friend void verifymaps();
     friend void dumpmaps();
@@ -307,6 +361,7 @@ class CharSetCvtEUCJPtoUTF8 : public CharSetCvt {
 
 private:
     static MapEnt EUCJPtoUCS2[];
+    static MapIndex EUCJPtoUCS2Index;
 
     friend void verifymaps();
     friend void dumpmaps();
@@ -356,8 +411,8 @@ private:
 
 class CharSetCvtUTF8toCp : public CharSetCvtFromUTF8 {
  protected:
-    CharSetCvtUTF8toCp( const MapEnt *tMap, int toSz )
-	: toMap(tMap), toMapSize(toSz) {}
+    CharSetCvtUTF8toCp( const MapEnt *tMap, int toSz, MapIndex *tIndex )
+	: toMap(tMap), toMapSize(toSz), toIndex(tIndex) {}
 
  public:
     virtual int Cvt(const char **sourcestart, const char *sourceend,
@@ -366,6 +421,7 @@ class CharSetCvtUTF8toCp : public CharSetCvtFromUTF8 {
 private:
     const MapEnt *toMap;
     int toMapSize;
+    MapIndex *toIndex;
     virtual void printmap( unsigned short, unsigned short, unsigned short );
     virtual void printmap( unsigned short, unsigned short );
 };
@@ -373,7 +429,8 @@ private:
 class CharSetCvtUTF8toCp949 : public CharSetCvtUTF8toCp
 {
     public:
-	CharSetCvtUTF8toCp949() : CharSetCvtUTF8toCp( UCS2toCp949, MapCount() ) {}
+	CharSetCvtUTF8toCp949() : CharSetCvtUTF8toCp( UCS2toCp949, MapCount(),
+				&UCS2toCp949Index ) {}
 
 	virtual CharSetCvt *Clone();
 
@@ -383,6 +440,7 @@ class CharSetCvtUTF8toCp949 : public CharSetCvtUTF8toCp
 
     private:
 	static MapEnt UCS2toCp949[];
+	static MapIndex UCS2toCp949Index;
 
     friend void verifymaps();
     friend void dumpmaps();
@@ -393,7 +451,8 @@ class CharSetCvtUTF8toCp949 : public CharSetCvtUTF8toCp
 class CharSetCvtUTF8toCp936 : public CharSetCvtUTF8toCp
 {
     public:
-	CharSetCvtUTF8toCp936() : CharSetCvtUTF8toCp( UCS2toCp936, MapCount() ) {}
+	CharSetCvtUTF8toCp936() : CharSetCvtUTF8toCp( UCS2toCp936, MapCount(),
+				&UCS2toCp936Index ) {}
 
 	virtual CharSetCvt *Clone();
 
@@ -403,6 +462,7 @@ class CharSetCvtUTF8toCp936 : public CharSetCvtUTF8toCp
 
     private:
 	static MapEnt UCS2toCp936[];
+	static MapIndex UCS2toCp936Index;
 
     friend void verifymaps();
     friend void dumpmaps();
@@ -413,7 +473,8 @@ class CharSetCvtUTF8toCp936 : public CharSetCvtUTF8toCp
 class CharSetCvtUTF8toCp950 : public CharSetCvtUTF8toCp
 {
     public:
-	CharSetCvtUTF8toCp950() : CharSetCvtUTF8toCp( UCS2toCp950, MapCount() ) {}
+	CharSetCvtUTF8toCp950() : CharSetCvtUTF8toCp( UCS2toCp950, MapCount(),
+				&UCS2toCp950Index ) {}
 
 	virtual CharSetCvt *Clone();
 
@@ -423,6 +484,7 @@ class CharSetCvtUTF8toCp950 : public CharSetCvtUTF8toCp
 
     private:
 	static MapEnt UCS2toCp950[];
+	static MapIndex UCS2toCp950Index;
 
     friend void verifymaps();
     friend void dumpmaps();
@@ -432,8 +494,8 @@ class CharSetCvtUTF8toCp950 : public CharSetCvtUTF8toCp
 
 class CharSetCvtCptoUTF8 : public CharSetCvt {
  protected:
-    CharSetCvtCptoUTF8( const MapEnt *tMap, int toSz )
-	: toMap(tMap), toMapSize(toSz) {}
+    CharSetCvtCptoUTF8( const MapEnt *tMap, int toSz, MapIndex *tIndex )
+	: toMap(tMap), toMapSize(toSz), toIndex(tIndex) {}
 
  public:
     virtual int Cvt(const char **sourcestart, const char *sourceend,
@@ -442,6 +504,7 @@ class CharSetCvtCptoUTF8 : public CharSetCvt {
  private:
     const MapEnt *toMap;
     int toMapSize;
+    MapIndex *toIndex;
     virtual int isDoubleByte( int leadByte ) = 0;
     virtual void printmap( unsigned short, unsigned short, unsigned short );
     virtual void printmap( unsigned short, unsigned short );
@@ -450,7 +513,8 @@ class CharSetCvtCptoUTF8 : public CharSetCvt {
 class CharSetCvtCp949toUTF8 : public CharSetCvtCptoUTF8
 {
     public:
-	CharSetCvtCp949toUTF8() : CharSetCvtCptoUTF8( Cp949toUCS2, MapCount() ) {}
+	CharSetCvtCp949toUTF8() : CharSetCvtCptoUTF8( Cp949toUCS2, MapCount(),
+				&Cp949toUCS2Index ) {}
 
 	virtual CharSetCvt *Clone();
 
@@ -462,6 +526,7 @@ class CharSetCvtCp949toUTF8 : public CharSetCvtCptoUTF8
 
     private:
 	static MapEnt Cp949toUCS2[];
+	static MapIndex Cp949toUCS2Index;
 
     friend void verifymaps();
     friend void dumpmaps();
@@ -473,7 +538,8 @@ class CharSetCvtCp949toUTF8 : public CharSetCvtCptoUTF8
 class CharSetCvtCp936toUTF8 : public CharSetCvtCptoUTF8
 {
     public:
-	CharSetCvtCp936toUTF8() : CharSetCvtCptoUTF8( Cp936toUCS2, MapCount() ) {}
+	CharSetCvtCp936toUTF8() : CharSetCvtCptoUTF8( Cp936toUCS2, MapCount(),
+				&Cp936toUCS2Index ) {}
 
 	virtual CharSetCvt *Clone();
 
@@ -485,6 +551,7 @@ class CharSetCvtCp936toUTF8 : public CharSetCvtCptoUTF8
 
     private:
 	static MapEnt Cp936toUCS2[];
+	static MapIndex Cp936toUCS2Index;
 
     friend void verifymaps();
     friend void dumpmaps();
@@ -496,7 +563,8 @@ class CharSetCvtCp936toUTF8 : public CharSetCvtCptoUTF8
 class CharSetCvtCp950toUTF8 : public CharSetCvtCptoUTF8
 {
     public:
-	CharSetCvtCp950toUTF8() : CharSetCvtCptoUTF8( Cp950toUCS2, MapCount() ) {}
+	CharSetCvtCp950toUTF8() : CharSetCvtCptoUTF8( Cp950toUCS2, MapCount(),
+				&Cp950toUCS2Index ) {}
 
 	virtual CharSetCvt *Clone();
 
@@ -508,6 +576,7 @@ class CharSetCvtCp950toUTF8 : public CharSetCvtCptoUTF8
 
     private:
 	static MapEnt Cp950toUCS2[];
+	static MapIndex Cp950toUCS2Index;
 
     friend void verifymaps();
     friend void dumpmaps();
@@ -0,0 +1,364 @@
+/*
+ * Copyright 2024 Perforce Software.  All rights reserved.
+ *
+ * This file is part of Perforce - the FAST SCM System.
+ */
+
+#include <stdhdrs.h>
+
+#include "charscan.h"
+
+/*
+ * charscan.cc -- bulk scanning for the character set converters
+ */
+
+# if defined( __x86_64__ ) || defined( _M_X64 )
+# define CHARSCAN_SSE2
+# include <emmintrin.h>
+# if defined( __GNUC__ ) || defined( __clang__ )
+# define CHARSCAN_AVX2
+# include <immintrin.h>
+# endif
+# elif defined( __aarch64__ ) || defined( _M_ARM64 )
+# define CHARSCAN_NEON
+# include <arm_neon.h>
+# endif
+
+/*
+ * LowBit() - index of the lowest set bit of a nonzero mask
+ */
+
+static inline int
+LowBit( unsigned int m )
+{
+# if defined( __GNUC__ ) || defined( __clang__ )
+	return __builtin_ctz( m );
+# else
+	int i = 0;
+	while( !( m & 1 ) )
+	    m >>= 1, ++i;
+	return i;
+# endif
+}
+
+/*
+ * Scalar versions, also used for the tails of the vector versions
+ *
+ *	'lim' is the first byte value that ends an ASCII run: 0x80, or
+ *	0x7f to stop at DEL too.
+ */
+
+static inline int
+AsciiScalar( const unsigned char *p, int i, int n, unsigned char lim )
+{
+	while( i < n && p[i] < lim )
+	    ++i;
+
+	return i;
+}
+
+/*
+ * Utf8Boundary() - back i off to the start of a character left open
+ *
+ *	p[0..i) is valid UTF-8 but for its last character, which may
+ *	need bytes from i on.
+ */
+
+static inline int
+Utf8Boundary( const unsigned char *p, int i )
+{
+	if( i >= 1 && p[i-1] >= 0xc0 )
+	    return i - 1;
+	if( i >= 2 && p[i-2] >= 0xe0 )
+	    return i - 2;
+	if( i >= 3 && p[i-3] >= 0xf0 )
+	    return i - 3;
+
+	return i;
+}
+
+# ifdef CHARSCAN_SSE2
+
+static int
+AsciiSse2( const unsigned char *p, int n, unsigned char lim )
+{
+	const __m128i del = _mm_set1_epi8( 0x7f );
+
+	int i = 0;
+
+	for( ; i + 16 <= n; i += 16 )
+	{
+	    __m128i v = _mm_loadu_si128( (const __m128i *)( p + i ) );
+
+	    unsigned bits = _mm_movemask_epi8( v );
+
+	    if( lim < 0x80 )
+		bits |= _mm_movemask_epi8( _mm_cmpeq_epi8( v, del ) );
+
+	    if( bits )
+		return i + LowBit( bits );
+	}
+
+	return AsciiScalar( p, i, n, lim );
+}
+
+# endif
+
+# ifdef CHARSCAN_AVX2
+
+__attribute__(( target( "avx2" ) ))
+static int
+AsciiAvx2( const unsigned char *p, int n, unsigned char lim )
+{
+	const __m256i del = _mm256_set1_epi8( 0x7f );
+
+	int i = 0;
+
+	for( ; i + 32 <= n; i += 32 )
+	{
+	    __m256i v = _mm256_loadu_si256( (const __m256i *)( p + i ) );
+
+	    unsigned bits = (unsigned)_mm256_movemask_epi8( v );
+
+	    if( lim < 0x80 )
+		bits |= (unsigned)_mm256_movemask_epi8(
+			_mm256_cmpeq_epi8( v, del ) );
+
+	    if( bits )
+		return i + LowBit( bits );
+	}
+
+	return i + AsciiSse2( p + i, n - i, lim );
+}
+
+/*
+ * Utf8Avx2() - validate 32 bytes at a time
+ *
+ *	Each byte and the one before it are classified by three table
+ *	lookups (the high and low nibbles of the first byte, the high
+ *	nibble of the second), whose AND is nonzero for an invalid
+ *	pair: a lead without a continuation, a stray continuation, an
+ *	overlong form, a surrogate or a value past U+10FFFF.  The
+ *	third and fourth bytes of longer characters are checked from
+ *	the bytes two and three back.
+ */
+
+# define U8_TOO_SHORT	( 1 << 0 )	// lead, then no continuation
+# define U8_TOO_LONG	( 1 << 1 )	// ASCII, then a continuation
+# define U8_OVERLONG_3	( 1 << 2 )	// 11100000 100_____
+# define U8_TOO_LARGE	( 1 << 3 )	// 11110100 1001____ and up
+# define U8_SURROGATE	( 1 << 4 )	// 11101101 101_____
+# define U8_OVERLONG_2	( 1 << 5 )	// 1100000_ 10______
+# define U8_TOO_LARGE_1000 ( 1 << 6 )	// 11110101 1000____ and up
+# define U8_OVERLONG_4	( 1 << 6 )	// 11110000 1000____
+# define U8_TWO_CONTS	( 1 << 7 )	// continuation, then another
+# define U8_CARRY	( U8_TOO_SHORT | U8_TOO_LONG | U8_TWO_CONTS )
+
+__attribute__(( target( "avx2" ) ))
+static inline __m256i
+Lookup16( __m256i table, __m256i nibbles )
+{
+	return _mm256_shuffle_epi8( table, nibbles );
+}
+
+__attribute__(( target( "avx2" ) ))
+static int
+Utf8Avx2( const unsigned char *p, int n )
+{
+	const __m256i hi1 = _mm256_setr_epi8(
+		U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG,
+		U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG,
+		U8_TWO_CONTS, U8_TWO_CONTS, U8_TWO_CONTS, U8_TWO_CONTS,
+		U8_TOO_SHORT | U8_OVERLONG_2,
+		U8_TOO_SHORT,
+		U8_TOO_SHORT | U8_OVERLONG_3 | U8_SURROGATE,
+		U8_TOO_SHORT | U8_TOO_LARGE | U8_TOO_LARGE_1000 |
+			U8_OVERLONG_4,
+		U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG,
+		U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG, U8_TOO_LONG,
+		U8_TWO_CONTS, U8_TWO_CONTS, U8_TWO_CONTS, U8_TWO_CONTS,
+		U8_TOO_SHORT | U8_OVERLONG_2,
+		U8_TOO_SHORT,
+		U8_TOO_SHORT | U8_OVERLONG_3 | U8_SURROGATE,
+		U8_TOO_SHORT | U8_TOO_LARGE | U8_TOO_LARGE_1000 |
+			U8_OVERLONG_4 );
+
+	const int big = U8_CARRY | U8_TOO_LARGE | U8_TOO_LARGE_1000;
+
+	const __m256i lo1 = _mm256_setr_epi8(
+		U8_CARRY | U8_OVERLONG_3 | U8_OVERLONG_2 | U8_OVERLONG_4,
+		U8_CARRY | U8_OVERLONG_2,
+		U8_CARRY,
+		U8_CARRY,
+		U8_CARRY | U8_TOO_LARGE,
+		big, big, big, big, big, big, big, big,
+		big | U8_SURROGATE,
+		big, big,
+		U8_CARRY | U8_OVERLONG_3 | U8_OVERLONG_2 | U8_OVERLONG_4,
+		U8_CARRY | U8_OVERLONG_2,
+		U8_CARRY,
+		U8_CARRY,
+		U8_CARRY | U8_TOO_LARGE,
+		big, big, big, big, big, big, big, big,
+		big | U8_SURROGATE,
+		big, big );
+
+	const int cont = U8_TOO_LONG | U8_OVERLONG_2 | U8_TWO_CONTS;
+
+	const __m256i hi2 = _mm256_setr_epi8(
+		U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT,
+		U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT,
+		cont | U8_OVERLONG_3 | U8_TOO_LARGE_1000 | U8_OVERLONG_4,
+		cont | U8_OVERLONG_3 | U8_TOO_LARGE,
+		cont | U8_SURROGATE | U8_TOO_LARGE,
+		cont | U8_SURROGATE | U8_TOO_LARGE,
+		U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT,
+		U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT,
+		U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT,
+		cont | U8_OVERLONG_3 | U8_TOO_LARGE_1000 | U8_OVERLONG_4,
+		cont | U8_OVERLONG_3 | U8_TOO_LARGE,
+		cont | U8_SURROGATE | U8_TOO_LARGE,
+		cont | U8_SURROGATE | U8_TOO_LARGE,
+		U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT, U8_TOO_SHORT );
+
+	const __m256i nibble = _mm256_set1_epi8( 0x0f );
+	const __m256i high = _mm256_set1_epi8( (char)0x80 );
+	const __m256i third = _mm256_set1_epi8( 0xe0 - 0x80 );
+	const __m256i fourth = _mm256_set1_epi8( 0xf0 - 0x80 );
+
+	// As if ASCII came before p: the caller is between characters.
+
+	__m256i prev = _mm256_setzero_si256();
+
+	int i = 0;
+	int bad = 0;
+
+	for( ; i + 32 <= n; i += 32 )
+	{
+	    __m256i in = _mm256_loadu_si256( (const __m256i *)( p + i ) );
+
+	    // All ASCII, with no character left open before it.
+
+	    if( !_mm256_movemask_epi8( in ) && Utf8Boundary( p, i ) == i )
+	    {
+		prev = in;
+		continue;
+	    }
+
+	    // The bytes 1, 2 and 3 back, across the block boundary
+
+	    __m256i carry = _mm256_permute2x128_si256( prev, in, 0x21 );
+	    __m256i prev1 = _mm256_alignr_epi8( in, carry, 15 );
+	    __m256i prev2 = _mm256_alignr_epi8( in, carry, 14 );
+	    __m256i prev3 = _mm256_alignr_epi8( in, carry, 13 );
+
+	    __m256i sc = _mm256_and_si256(
+		_mm256_and_si256(
+		    Lookup16( hi1, _mm256_and_si256(
+			_mm256_srli_epi16( prev1, 4 ), nibble ) ),
+		    Lookup16( lo1, _mm256_and_si256( prev1, nibble ) ) ),
+		Lookup16( hi2, _mm256_and_si256(
+			_mm256_srli_epi16( in, 4 ), nibble ) ) );
+
+	    // Bytes that must be a third or fourth byte have the high
+	    // bit here, and two continuations in a row there.
+
+	    __m256i must23 = _mm256_and_si256( _mm256_or_si256(
+		_mm256_subs_epu8( prev2, third ),
+		_mm256_subs_epu8( prev3, fourth ) ), high );
+
+	    __m256i err = _mm256_xor_si256( must23, sc );
+
+	    if( !_mm256_testz_si256( err, err ) )
+	    {
+		bad = 1;
+		break;
+	    }
+
+	    prev = in;
+	}
+
+	// Leave any character open at i (or the block with an error)
+	// to the caller.
+
+	int j = Utf8Boundary( p, i );
+
+	if( bad || j < i )
+	    return j;
+
+	return i + AsciiSse2( p + i, n - i, 0x80 );
+}
+
+/*
+ * HaveAvx2() - ask the CPU once; a racing first call just asks twice
+ */
+
+static int
+HaveAvx2()
+{
+	static int have = -1;
+
+	if( have < 0 )
+	{
+	    __builtin_cpu_init();
+	    have = __builtin_cpu_supports( "avx2" ) ? 1 : 0;
+	}
+
+	return have;
+}
+
+# endif
+
+# ifdef CHARSCAN_NEON
+
+static int
+AsciiNeon( const unsigned char *p, int n, unsigned char lim )
+{
+	const uint8x16_t l = vdupq_n_u8( lim );
+
+	int i = 0;
+
+	for( ; i + 16 <= n; i += 16 )
+	    if( vmaxvq_u8( vcgeq_u8( vld1q_u8( p + i ), l ) ) )
+		break;
+
+	return AsciiScalar( p, i, n, lim );
+}
+
+# endif
+
+/*
+ * CharScanAscii() - length of the run of 7-bit characters at p
+ */
+
+int
+CharScanAscii( const unsigned char *p, int n, int del )
+{
+	unsigned char lim = del ? 0x80 : 0x7f;
+
+# if defined( CHARSCAN_AVX2 )
+	if( HaveAvx2() )
+	    return AsciiAvx2( p, n, lim );
+# endif
+# if defined( CHARSCAN_SSE2 )
+	return AsciiSse2( p, n, lim );
+# elif defined( CHARSCAN_NEON )
+	return AsciiNeon( p, n, lim );
+# else
+	return AsciiScalar( p, 0, n, lim );
+# endif
+}
+
+/*
+ * CharScanUtf8() - length of a run of whole, valid UTF-8 at p
+ */
+
+int
+CharScanUtf8( const unsigned char *p, int n )
+{
+# if defined( CHARSCAN_AVX2 )
+	if( HaveAvx2() )
+	    return Utf8Avx2( p, n );
+# endif
+	return CharScanAscii( p, n, 1 );
+}
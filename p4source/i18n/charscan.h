@@ -0,0 +1,33 @@
+/*
+ * Copyright 2024 Perforce Software.  All rights reserved.
+ *
+ * This file is part of Perforce - the FAST SCM System.
+ */
+
+/*
+ * charscan.h -- bulk scanning for the character set converters
+ *
+ * Functions defined:
+ *
+ *	CharScanAscii() - length of the run of 7-bit characters at p
+ *	CharScanUtf8() - length of a run of whole, valid UTF-8 at p
+ *
+ * Notes:
+ *
+ *	CharScanAscii( p, n, del ) stops at the first byte with the high
+ *	bit set, and also at DEL (0x7f) unless 'del' is set.
+ *
+ *	CharScanUtf8( p, n ) may stop short of the first invalid or
+ *	partial character, but never passes one: the run it returns is
+ *	what CharSetUTF8Valid would accept, ending between characters.
+ *	Without AVX2 it stops at the first byte that isn't ASCII.
+ *
+ *	On x86_64 the scans use SSE2 and, where the CPU has it, AVX2,
+ *	with which UTF-8 is validated 32 bytes at a time (after Keiser
+ *	and Lemire, "Validating UTF-8 In Less Than One Instruction Per
+ *	Byte").  On aarch64 the ASCII scan uses NEON.  Other platforms
+ *	get the scalar code.
+ */
+
+int	CharScanAscii( const unsigned char *p, int n, int del );
+int	CharScanUtf8( const unsigned char *p, int n );
@@ -43601,8 +43601,16 @@ CharSetCvtUTF8toCp936::MapCount()
 	return sizeof(UCS2toCp936) / sizeof(*UCS2toCp936);
 }
 
+CharSetCvt::MapIndex
+CharSetCvtUTF8toCp936::UCS2toCp936Index( UCS2toCp936,
+	sizeof(UCS2toCp936) / sizeof(*UCS2toCp936), 0xfffd );
+
 int
 CharSetCvtCp936toUTF8::MapCount()
 {
 	return sizeof(Cp936toUCS2) / sizeof(*Cp936toUCS2);
 }
+
+CharSetCvt::MapIndex
+CharSetCvtCp936toUTF8::Cp936toUCS2Index( Cp936toUCS2,
+	sizeof(Cp936toUCS2) / sizeof(*Cp936toUCS2), 0xfffd );
@@ -27013,8 +27013,16 @@ CharSetCvtUTF8toCp950::MapCount()
 	return sizeof(UCS2toCp950) / sizeof(*UCS2toCp950);
 }
 
+CharSetCvt::MapIndex
+CharSetCvtUTF8toCp950::UCS2toCp950Index( UCS2toCp950,
+	sizeof(UCS2toCp950) / sizeof(*UCS2toCp950), 0xfffd );
+
 int
 CharSetCvtCp950toUTF8::MapCount()
 {
 	return sizeof(Cp950toUCS2) / sizeof(*Cp950toUCS2);
 }
+
+CharSetCvt::MapIndex
+CharSetCvtCp950toUTF8::Cp950toUCS2Index( Cp950toUCS2,
+	sizeof(Cp950toUCS2) / sizeof(*Cp950toUCS2), 0xfffd );
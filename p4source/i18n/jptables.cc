@@ -7538,6 +7538,10 @@ CharSetCvtUTF8toShiftJis::MapCount()
 	return sizeof(UCS2toShiftJis) / sizeof(*UCS2toShiftJis);
 }
 
+CharSetCvt::MapIndex
+CharSetCvtUTF8toShiftJis::UCS2toShiftJisIndex( UCS2toShiftJis,
+	sizeof(UCS2toShiftJis) / sizeof(*UCS2toShiftJis), 0xfffd );
+
 CharSetCvt::MapEnt
 CharSetCvtShiftJistoUTF8::ShiftJistoUCS2[] = {
 {0x20,0x0020},
@@ -15447,6 +15451,10 @@ CharSetCvtShiftJistoUTF8::MapCount()
 	return sizeof(ShiftJistoUCS2) / sizeof(*ShiftJistoUCS2);
 }
 
+CharSetCvt::MapIndex
+CharSetCvtShiftJistoUTF8::ShiftJistoUCS2Index( ShiftJistoUCS2,
+	sizeof(ShiftJistoUCS2) / sizeof(*ShiftJistoUCS2), 0xfffd );
+
 CharSetCvt::MapEnt
 CharSetCvtUTF8toEUCJP::UCS2toEUCJP[] = {
 # ifndef OS_LYNX
@@ -18597,6 +18605,10 @@ CharSetCvtUTF8toEUCJP::MapCount()
 	return sizeof(UCS2toEUCJP) / sizeof(*UCS2toEUCJP);
 }
 
+CharSetCvt::MapIndex
+CharSetCvtUTF8toEUCJP::UCS2toEUCJPIndex( UCS2toEUCJP,
+	sizeof(UCS2toEUCJP) / sizeof(*UCS2toEUCJP), 0xfffd );
+
 CharSetCvt::MapEnt
 CharSetCvtEUCJPtoUTF8::EUCJPtoUCS2[] = {
 # ifndef OS_LYNX
@@ -21813,3 +21825,7 @@ CharSetCvtEUCJPtoUTF8::MapCount()
 {
 	return sizeof(EUCJPtoUCS2) / sizeof(*EUCJPtoUCS2);
 }
+
+CharSetCvt::MapIndex
+CharSetCvtEUCJPtoUTF8::EUCJPtoUCS2Index( EUCJPtoUCS2,
+	sizeof(EUCJPtoUCS2) / sizeof(*EUCJPtoUCS2), 0xfffd );
@@ -17077,6 +17077,10 @@ CharSetCvtUTF8toCp949::MapCount()
 	return sizeof(UCS2toCp949) / sizeof(*UCS2toCp949);
 }
 
+CharSetCvt::MapIndex
+CharSetCvtUTF8toCp949::UCS2toCp949Index( UCS2toCp949,
+	sizeof(UCS2toCp949) / sizeof(*UCS2toCp949), 0xfffd );
+
 CharSetCvt::MapEnt
 CharSetCvtCp949toUTF8::Cp949toUCS2[] = {
 {0x8141, 0xAC02},
@@ -34134,3 +34138,7 @@ CharSetCvtCp949toUTF8::MapCount()
 {
 	return sizeof(Cp949toUCS2) / sizeof(*Cp949toUCS2);
 }
+
+CharSetCvt::MapIndex
+CharSetCvtCp949toUTF8::Cp949toUCS2Index( Cp949toUCS2,
+	sizeof(Cp949toUCS2) / sizeof(*Cp949toUCS2), 0xfffd );
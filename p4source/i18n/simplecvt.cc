@@ -43,6 +43,14 @@ CharSetCvtUTF8toSimple::Cvt(const char **sourcestart,
 	while (*sourcestart < sourceend && *targetstart < targetend)
 	{
 	    v = **sourcestart & 0xff;
+
+	    if (!(v & 0x80) &&
+		CopyAscii(sourcestart, sourceend, targetstart, targetend))
+	    {
+		checkBOM = 0;
+		continue;
+	    }
+
 	    int l;
 	    if (v & 0x80)
 	    {
@@ -134,6 +142,11 @@ CharSetCvtSimpletoUTF8::Cvt(const char **sourcestart,
 	while (*sourcestart < sourceend && *targetstart < targetend)
 	{
 	    v = **sourcestart & 0xff;
+
+	    if (!(v & 0x80) &&
+		CopyAscii(sourcestart, sourceend, targetstart, targetend))
+		continue;
+
 	    if (v & 0x80)
 	    {
 		if( v < off )
@@ -3862,6 +3875,14 @@ CharSetCvtUTF8to8859_1::Cvt(const char **sourcestart, const char *sourceend,
 	while (*sourcestart < sourceend && *targetstart < targetend)
 	{
 	    v = **sourcestart & 0xff;
+
+	    if (!(v & 0x80) &&
+		CopyAscii(sourcestart, sourceend, targetstart, targetend))
+	    {
+		checkBOM = 0;
+		continue;
+	    }
+
 	    if (v & 0x80)
 	    {
 		int l = bytesFromUTF8[v];
@@ -3935,6 +3956,11 @@ CharSetCvt8859_1toUTF8::Cvt(const char **sourcestart, const char *sourceend,
 	while (*sourcestart < sourceend && *targetstart < targetend)
 	{
 	    v = **sourcestart & 0xff;
+
+	    if (!(v & 0x80) &&
+		CopyAscii(sourcestart, sourceend, targetstart, targetend))
+		continue;
+
 	    if (v & 0x80)
 	    {
 		if (1 + *targetstart == targetend)
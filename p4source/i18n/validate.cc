@@ -5,6 +5,7 @@
  */
 
 #include "validate.h"
+#include "charscan.h"
 
 /*
  * ValidateCharSet
@@ -89,54 +90,74 @@ CharSetUTF8Valid::validmap[256] = {
  * 0 not valid
  * 1 valid
  * 3 valid so far (following bytes needed to complete a multi-byte char)
+ *
+ * Between characters, CharScanUtf8() passes over as much as it can
+ * at once; the rest is checked a byte at a time, up to the next
+ * ASCII character.
  */
 
 int
 CharSetUTF8Valid::Valid( const char *buf, int len, const char **retp )
 {
-	while( len-- > 0 )
+	while( len > 0 )
 	{
-	    int chflags = validmap[0xff & *buf];
+	    if( !followcnt )
+	    {
+		int n = CharScanUtf8( (const unsigned char *)buf, len );
+
+		buf += n;
+		len -= n;
+
+		if( !len )
+		    break;
+	    }
 
-	    if( followcnt )
+	    do
 	    {
-		if( ( chflags & 0x80 ) != 0x80 )
-		    return 0;
-		--followcnt;
-		if( magic )
+		int chflags = validmap[0xff & *buf];
+
+		if( followcnt )
 		{
-		    switch( magic )
+		    if( ( chflags & 0x80 ) != 0x80 )
+			return 0;
+		    --followcnt;
+		    if( magic )
 		    {
-		    case 0x10:	// lead is 0xf4
-			if( ( chflags & 0x20 ) != 0x20 )
-			    return 0;
-			break;
-		    case 0x20:	// lead is 0xf0
-			if( ( chflags & 0x20 ) == 0x20 )
-			    return 0;
-			break;
-		    case 0x30:	// lead is 0xe0
-			if( ( chflags & 0x10 ) == 0x10 )
-			    return 0;
-			break;
-		    case 0x08:	// lead is 0xed (UTF-16 surrogates)
-			if( ( chflags & 0x30 ) == 0x00 )
-			    return 0;
-			break;
+			switch( magic )
+			{
+			case 0x10:	// lead is 0xf4
+			    if( ( chflags & 0x20 ) != 0x20 )
+				return 0;
+			    break;
+			case 0x20:	// lead is 0xf0
+			    if( ( chflags & 0x20 ) == 0x20 )
+				return 0;
+			    break;
+			case 0x30:	// lead is 0xe0
+			    if( ( chflags & 0x10 ) == 0x10 )
+				return 0;
+			    break;
+			case 0x08:	// lead is 0xed (UTF-16 surrogates)
+			    if( ( chflags & 0x30 ) == 0x00 )
+				return 0;
+			    break;
+			}
+			magic = 0;
 		    }
-		    magic = 0;
 		}
+		else
+		{
+		    if( retp )
+			*retp = buf;
+		    if( ( chflags & 0x40 ) != 0x40 )
+			return 0;
+		    followcnt = chflags & 0x7;
+		    magic = chflags & 0x38;
+		}
+		buf++;
+		len--;
 	    }
-	    else
-	    {
-		if( retp )
-		    *retp = buf;
-		if( ( chflags & 0x40 ) != 0x40 )
-		    return 0;
-		followcnt = chflags & 0x7;
-		magic = chflags & 0x38;
-	    }
-	    buf++;
+	    while( len > 0 && ( followcnt || ( *buf & 0x80 ) ) );
 	}
 	if( followcnt )
 	    return 3;
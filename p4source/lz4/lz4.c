@@ -0,0 +1,394 @@
+/*
+ * Copyright 2024 Perforce Software.  All rights reserved.
+ *
+ * This file is part of Perforce - the FAST SCM System.
+ */
+
+/*
+ * lz4.c - LZ4 block compression
+ *
+ * A block is a run of sequences.  Each sequence is:
+ *
+ *	token		literal length (high 4 bits), match length - 4 (low 4)
+ *	[ 255 ... n ]	more literal length, if the high nibble was 15
+ *	literals
+ *	offset		2 bytes, little endian: how far back the match is
+ *	[ 255 ... n ]	more match length, if the low nibble was 15
+ *
+ * The last sequence has only literals.  The last 5 bytes of a block are
+ * always literals, and the last match starts at least 12 bytes from
+ * the end, so that a decoder may copy in 8 byte steps.
+ *
+ * Only three calls of the reference lz4.h next to this file are here:
+ * LZ4_compressBound(), LZ4_compress_default() and LZ4_decompress_safe().
+ * See README.txt.
+ */
+
+# include <string.h>
+
+# include "lz4.h"
+
+typedef unsigned char	BYTE;
+typedef unsigned int	U32;
+typedef unsigned long long U64;
+
+# define MINMATCH	4
+# define LASTLITERALS	5
+# define MFLIMIT	12
+# define MAX_DISTANCE	65535
+# define ML_MASK	15
+# define RUN_MASK	15
+
+# define HASH_LOG	12
+# define SKIP_TRIGGER	6
+
+static U32
+Read32( const BYTE *p )
+{
+	U32 v;
+	memcpy( &v, p, sizeof( v ) );
+	return v;
+}
+
+static U32
+Hash( const BYTE *p )
+{
+	return ( Read32( p ) * 2654435761U ) >> ( 32 - HASH_LOG );
+}
+
+static int
+IsLittleEndian( void )
+{
+	const union { U32 u; BYTE c[4]; } one = { 1 };
+	return one.c[0];
+}
+
+/*
+ * Count() - how many bytes at p match those at m, stopping at limit
+ */
+
+static unsigned
+Count( const BYTE *p, const BYTE *m, const BYTE *limit )
+{
+	const BYTE *start = p;
+
+	if( IsLittleEndian() )
+	{
+	    while( p + 8 <= limit )
+	    {
+		U64 a, b;
+		memcpy( &a, p, 8 );
+		memcpy( &b, m, 8 );
+
+		if( a != b )
+		{
+# if defined( __GNUC__ ) || defined( __clang__ )
+		    return (unsigned)( p - start ) +
+			( __builtin_ctzll( a ^ b ) >> 3 );
+# else
+		    break;
+# endif
+		}
+
+		p += 8;
+		m += 8;
+	    }
+	}
+
+	while( p < limit && *p == *m )
+	    ++p, ++m;
+
+	return (unsigned)( p - start );
+}
+
+/*
+ * PutLength() - the 255 ... n tail of a length over 15
+ */
+
+static BYTE *
+PutLength( BYTE *op, unsigned len )
+{
+	for( ; len >= 255; len -= 255 )
+	    *op++ = 255;
+	*op++ = (BYTE)len;
+	return op;
+}
+
+int
+LZ4_compressBound( int n )
+{
+	return (unsigned)n > LZ4_MAX_INPUT_SIZE ? 0 : n + n / 255 + 16;
+}
+
+int
+LZ4_compress_default( const char *source, char *dest,
+		      int srcSize, int dstCapacity )
+{
+	U32 table[ 1 << HASH_LOG ];
+
+	const BYTE *base = (const BYTE *)source;
+	const BYTE *ip = base;
+	const BYTE *anchor = base;
+	const BYTE *iend = base + srcSize;
+	const BYTE *mflimit = iend - MFLIMIT;
+	const BYTE *matchlimit = iend - LASTLITERALS;
+
+	BYTE *op = (BYTE *)dest;
+	BYTE *oend = op + dstCapacity;
+
+	if( (unsigned)srcSize > LZ4_MAX_INPUT_SIZE || dstCapacity <= 0 )
+	    return 0;
+
+	if( srcSize < MFLIMIT + 1 )
+	    goto last_literals;
+
+	memset( table, 0, sizeof( table ) );
+
+	table[ Hash( ip ) ] = 0;
+	++ip;
+
+	for( ;; )
+	{
+	    const BYTE *match;
+	    const BYTE *forward = ip;
+	    unsigned step = 1;
+	    unsigned searches = 1 << SKIP_TRIGGER;
+	    BYTE *token;
+	    unsigned len;
+
+	    // Find a match, stepping further the longer we go without.
+
+	    do {
+		U32 h = Hash( forward );
+		ip = forward;
+		forward += step;
+		step = searches++ >> SKIP_TRIGGER;
+
+		if( forward > mflimit )
+		    goto last_literals;
+
+		match = base + table[ h ];
+		table[ h ] = (U32)( ip - base );
+
+	    } while( match + MAX_DISTANCE < ip || Read32( match ) != Read32( ip ) );
+
+	    // Extend it backwards over the pending literals.
+
+	    while( ip > anchor && match > base && ip[-1] == match[-1] )
+		--ip, --match;
+
+	    // Literals; check for room for them and the match to follow.
+
+	    len = (unsigned)( ip - anchor );
+
+	    if( op + 1 + len / 255 + 1 + len + 2 + 1 + LASTLITERALS > oend )
+		return 0;
+
+	    token = op++;
+
+	    if( len >= RUN_MASK )
+	    {
+		*token = RUN_MASK << 4;
+		op = PutLength( op, len - RUN_MASK );
+	    }
+	    else
+		*token = (BYTE)( len << 4 );
+
+	    memcpy( op, anchor, len );
+	    op += len;
+
+	next_match:
+
+	    op[0] = (BYTE)( ip - match );
+	    op[1] = (BYTE)( ( ip - match ) >> 8 );
+	    op += 2;
+
+	    len = Count( ip + MINMATCH, match + MINMATCH, matchlimit );
+	    ip += MINMATCH + len;
+
+	    if( op + len / 255 + 1 + 1 + LASTLITERALS > oend )
+		return 0;
+
+	    if( len >= ML_MASK )
+	    {
+		*token += ML_MASK;
+		op = PutLength( op, len - ML_MASK );
+	    }
+	    else
+		*token += (BYTE)len;
+
+	    anchor = ip;
+
+	    if( ip >= mflimit )
+		break;
+
+	    table[ Hash( ip - 2 ) ] = (U32)( ip - 2 - base );
+
+	    // Another match right here?  Then no literals.
+
+	    {
+		U32 h = Hash( ip );
+		match = base + table[ h ];
+		table[ h ] = (U32)( ip - base );
+
+		if( match + MAX_DISTANCE >= ip && Read32( match ) == Read32( ip ) )
+		{
+		    token = op++;
+		    *token = 0;
+		    goto next_match;
+		}
+	    }
+
+	    ++ip;
+	}
+
+    last_literals:
+
+	{
+	    unsigned len = (unsigned)( iend - anchor );
+
+	    if( op + 1 + ( len + 255 - RUN_MASK ) / 255 + len > oend )
+		return 0;
+
+	    if( len >= RUN_MASK )
+	    {
+		*op++ = RUN_MASK << 4;
+		op = PutLength( op, len - RUN_MASK );
+	    }
+	    else
+		*op++ = (BYTE)( len << 4 );
+
+	    memcpy( op, anchor, len );
+	    op += len;
+	}
+
+	return (int)( op - (BYTE *)dest );
+}
+
+int
+LZ4_decompress_safe( const char *source, char *dest,
+		     int compressedSize, int dstCapacity )
+{
+	const BYTE *ip = (const BYTE *)source;
+	const BYTE *iend = ip + compressedSize;
+
+	BYTE *op = (BYTE *)dest;
+	BYTE *ostart = op;
+	BYTE *oend = op + dstCapacity;
+
+	if( compressedSize <= 0 || dstCapacity < 0 )
+	    return -1;
+
+	for( ;; )
+	{
+	    unsigned token = *ip++;
+	    size_t len = token >> 4;
+	    size_t offset;
+	    const BYTE *match;
+	    unsigned s;
+
+	    // Literals.  Runs under 15 with 16 bytes to spare either side
+	    // are copied 16 at a time; such a run can't end the block.
+
+	    if( len < RUN_MASK && iend - ip >= 16 && oend - op >= 16 )
+	    {
+		memcpy( op, ip, 16 );
+		op += len;
+		ip += len;
+	    }
+	    else
+	    {
+		if( len == RUN_MASK )
+		{
+		    do {
+			if( ip >= iend )
+			    return -1;
+			s = *ip++;
+			len += s;
+		    } while( s == 255 );
+		}
+
+		if( len > (size_t)( iend - ip ) || len > (size_t)( oend - op ) )
+		    return -1;
+
+		memcpy( op, ip, len );
+		op += len;
+		ip += len;
+
+		// The last sequence ends the block after its literals.
+
+		if( ip == iend )
+		    break;
+	    }
+
+	    // Match
+
+	    if( iend - ip < 2 )
+		return -1;
+
+	    offset = ip[0] | ( ip[1] << 8 );
+	    ip += 2;
+
+	    if( !offset || offset > (size_t)( op - ostart ) )
+		return -1;
+
+	    match = op - offset;
+	    len = token & ML_MASK;
+
+	    // Short matches at least 8 back, with room, go 8 at a time.
+
+	    if( len < ML_MASK && offset >= 8 && oend - op >= 18 )
+	    {
+		memcpy( op, match, 8 );
+		memcpy( op + 8, match + 8, 8 );
+		memcpy( op + 16, match + 16, 2 );
+		op += len + MINMATCH;
+
+		if( ip >= iend )
+		    return -1;
+		continue;
+	    }
+
+	    if( len == ML_MASK )
+	    {
+		do {
+		    if( ip >= iend )
+			return -1;
+		    s = *ip++;
+		    len += s;
+		} while( s == 255 );
+	    }
+
+	    len += MINMATCH;
+
+	    if( len > (size_t)( oend - op ) )
+		return -1;
+
+	    // An overlapping match repeats its last offset bytes: copy
+	    // what's there, doubling each time, so no copy overlaps.
+
+	    if( offset >= len )
+	    {
+		memcpy( op, match, len );
+		op += len;
+	    }
+	    else
+	    {
+		BYTE *cpy = op + len;
+
+		while( op < cpy )
+		{
+		    size_t n = op - match;
+		    if( n > (size_t)( cpy - op ) )
+			n = cpy - op;
+		    memcpy( op, match, n );
+		    op += n;
+		}
+	    }
+
+	    if( ip >= iend )
+		return -1;
+	}
+
+	return (int)( op - ostart );
+}
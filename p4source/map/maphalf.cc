@@ -20,6 +20,35 @@
 # include "mapstring.h"
 # include "mapdebug.h"
 
+//
+// MapHalfCompiled - the wildcard portion, by MapHalf::Compile()
+//
+
+struct MapHalfSeg {
+	MapCharClass	cc;		// cSTAR, cPERC or cDOTS
+	int		param;		// MapChar::paramNumber
+	MapChar		*lit;		// literal following
+	const char	*text;		// ... as chars, for memcmp()
+	int		len;
+} ;
+
+struct MapHalfCompiled {
+
+			MapHalfCompiled( int n ) { segs = new MapHalfSeg[ n ]; }
+			~MapHalfCompiled() { delete []segs; }
+
+	int		Match( const StrPtr &from, int start, MapParams &p );
+
+	MapHalfSeg	*segs;
+	int		nSegs;
+	StrBuf		text;		// the literals
+
+    private:
+
+	int		MatchSeg( int i, const char *input, int len,
+				int start, MapParams &p );
+} ;
+
 //
 // MapHalf - half of a mapping, i.e. a pattern
 //
@@ -33,6 +62,7 @@
 //	MapHalf::HasEmbWild() - returns non-zero on embedded/leading wildcards
 //	MapHalf::HasPosWild() - returns non-zero on positional wildcards
 //	MapHalf::Match() - fast match a string against a map pattern
+//	MapHalf::Compile() - precompute the wildcard portion for Match2()
 //	MapHalf::Expand() - expand result of Match using a pattern
 //	MapHalf::Join() - join two MapHalfs together
 // 	MapHalf::Validate() - do these patterns have the same wildcards
@@ -58,6 +88,8 @@ MapHalf::operator =( const StrPtr &newHalf )
 	Set( newHalf );
 	delete []mapChar;
 	mapChar = new MapChar[ l ];
+	delete compiled;
+	compiled = 0;
 
 	// Compile into internal form.
 
@@ -145,6 +177,7 @@ MapHalf::HasEndSlashEllipses()
 MapHalf::~MapHalf()
 {
 	delete []mapChar;
+	delete compiled;
 }
 
 //
@@ -399,6 +432,169 @@ MapHalf::GetCommonLen( MapHalf *prev )
 // Match1 against another MapHalf only compares up to smallest fixedLen.
 //
 
+//
+// MapHalf::Compile() - precompute the wildcard portion for Match2()
+//
+// After the initial fixed string a pattern is a series of wildcards,
+// each followed by a (possibly empty) literal.  Match2() tries the
+// longest string for each wildcard first, backing off one character
+// at a time, the last wildcard first.  MapHalfCompiled::Match() tries
+// the same lengths in the same order, so it finds the same match,
+// but only stops where the following literal could start, compares
+// that with memcmp() where it can, and goes straight to the only
+// length the last wildcard can have: the input's end, less the
+// literal after it.
+//
+// Patterns that reuse a %%n, or have more wildcards than Match2()
+// can back up over or store, are left uncompiled.
+//
+
+void
+MapHalf::Compile()
+{
+	if( compiled || !mapChar || nWilds > PARAM_MAX_BACKTRACK * 2 )
+	    return;
+
+	int used = 0;
+	MapChar *mc;
+
+	for( mc = mapChar; mc->cc != cEOS; mc++ )
+	{
+	    if( !mc->IsWild() )
+		continue;
+
+	    if( mc->paramNumber >= PARAM_VECTOR_LENGTH || used & ( 1 << mc->paramNumber ) )
+		return;
+
+	    used |= 1 << mc->paramNumber;
+	}
+
+	MapHalfCompiled *c = new MapHalfCompiled( nWilds );
+	int *offs = new int[ nWilds ];
+
+	c->nSegs = 0;
+
+	for( mc = mapChar + fixedLen; mc->cc != cEOS; )
+	{
+	    offs[ c->nSegs ] = c->text.Length();
+
+	    MapHalfSeg *g = &c->segs[ c->nSegs++ ];
+
+	    g->cc = mc->cc;
+	    g->param = mc->paramNumber;
+	    g->lit = ++mc;
+
+	    while( mc->cc == cCHAR || mc->cc == cSLASH )
+		c->text.Extend( mc++->c );
+
+	    g->len = c->text.Length() - offs[ c->nSegs - 1 ];
+	}
+
+	// Now that text won't move
+
+	for( int i = 0; i < c->nSegs; i++ )
+	    c->segs[ i ].text = c->text.Text() + offs[ i ];
+
+	delete []offs;
+	compiled = c;
+}
+
+static int
+MapHalfLit( MapHalfSeg *g, const char *s )
+{
+	if( !memcmp( s, g->text, g->len ) )
+	    return 1;
+
+	// Not exactly the same, but the same ignoring case?
+
+	for( int i = 0; i < g->len; i++ )
+	    if( s[ i ] != g->text[ i ] && !( g->lit[ i ] == s[ i ] ) )
+		return 0;
+
+	return 1;
+}
+
+int
+MapHalfCompiled::MatchSeg(
+	int i,
+	const char *input,
+	int len,
+	int start,
+	MapParams &p )
+{
+	MapHalfSeg *g = &segs[ i ];
+
+	// How far can this wildcard reach, and still leave room
+	// for its literal?
+
+	int end = len;
+
+	if( g->cc != cDOTS )
+	{
+	    const char *s = (const char *)memchr( input + start, '/',
+						len - start );
+	    if( s )
+		end = s - input;
+	}
+
+	if( end > len - g->len )
+	    end = len - g->len;
+
+	// The last must leave just its literal.
+
+	if( i == nSegs - 1 )
+	{
+	    int at = len - g->len;
+
+	    if( at < start || at > end || !MapHalfLit( g, input + at ) )
+		return 0;
+
+	    p.vector[ g->param ].start = start;
+	    p.vector[ g->param ].end = at;
+	    return 1;
+	}
+
+	// Longest first, only where the literal could start.
+
+	for( int at = end; at >= start; --at )
+	{
+	    if( g->len &&
+		input[ at ] != g->text[ 0 ] &&
+		( input[ at ] ^ g->text[ 0 ] ) != ( 'A' ^ 'a' ) )
+		continue;
+
+	    if( !MapHalfLit( g, input + at ) )
+		continue;
+
+	    p.vector[ g->param ].start = start;
+	    p.vector[ g->param ].end = at;
+
+	    if( MatchSeg( i + 1, input, len, at + g->len, p ) )
+		return 1;
+	}
+
+	return 0;
+}
+
+int
+MapHalfCompiled::Match( const StrPtr &from, int start, MapParams &p )
+{
+	const char *input = from.Text();
+	int len = from.Length();
+
+	// Match2() stops at a null: so do we.
+
+	const char *z = (const char *)memchr( input + start, 0, len - start );
+
+	if( z )
+	    len = z - input;
+
+	if( !nSegs )
+	    return len == start;
+
+	return MatchSeg( 0, input, len, start, p );
+}
+
 int
 MapHalf::Match1( const StrPtr &from, int &coff )
 {
@@ -407,9 +603,17 @@ MapHalf::Match1( const StrPtr &from, int &coff )
 	// coff allows us to start at the point where this pattern
 	// differs from the previous (parent) pattern.
 
-	for( ; coff < fixedLen && coff < from.Length(); ++coff )
-	    if( int r = ( mapChar[ coff ] - from[ coff ] ) )
-		return -r;
+	// The fixed part is plain characters, the same as our text:
+	// only where they differ need the MapChar (case) compare.
+
+	const char *p = Text();
+	const char *f = from.Text();
+	int n = fixedLen < from.Length() ? fixedLen : from.Length();
+
+	for( ; coff < n; ++coff )
+	    if( p[ coff ] != f[ coff ] )
+		if( int r = ( mapChar[ coff ] - f[ coff ] ) )
+		    return -r;
 
 	if( from.Length() < fixedLen )
 	    return -1;
@@ -439,6 +643,11 @@ MapHalf::Match2( const StrPtr &from, MapParams &params )
 	            return 0;
 	}
 
+	// Compiled?  It leaves the rare hybrid case (below) to us.
+
+	if( compiled && !StrPtr::CaseHybrid() )
+	    return compiled->Match( from, fixedLen, params );
+
 	// Full match after initial fixed string.
 
 	mc = mapChar + fixedLen;
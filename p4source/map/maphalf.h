@@ -20,6 +20,12 @@
  *	MapHalf::Compare( const MapHalf &item )
  *		Just strcmp the pattern with the handed in one.
  *
+ *	MapHalf::Compile()
+ *		Build a faster form of the wildcard portion of the pattern
+ *		for Match2(), which then matches the same strings with the
+ *		same params.  Done by MapTable::MakeTree(), for the halves
+ *		that Translate() and friends will match against.
+ *
  *	MapHalf::GetCommonLen( MapHalf *prev )
  *		Returns the length of initial substring of non-wildcard 
  *		chararacters common to both MapHalf patterns.
@@ -88,6 +94,7 @@ const int PARAM_MAX_WILDS = 10;
 class MapChar;
 class MapHalf;
 struct MapString;
+struct MapHalfCompiled;
 
 struct MapParam {
 	int	start;		// offsets into Joiner::StrBuf::Text()
@@ -102,6 +109,8 @@ class Joiner : public StrBuf {
 
     public:
 
+	virtual		~Joiner() {}
+
 	virtual void	Insert() = 0;
 
         int             badJoin;
@@ -114,15 +123,16 @@ class MapHalf : public StrBuf {
 
     public:
 
-			MapHalf() { mapChar = 0; caseMode = -1; }
+			MapHalf() { mapChar = 0; compiled = 0; caseMode = -1; }
 			MapHalf( const StrPtr &n )
-			{ mapChar = 0; caseMode = -1; *this = n; }
+			{ mapChar = 0; compiled = 0; caseMode = -1; *this = n; }
 			~MapHalf();
 
 	void		operator =( const StrPtr &newHalf );
 
 	int		Compare( const MapHalf &item,
 				 bool strict = false ) const;
+	void		Compile();
 	int		GetCommonLen( MapHalf *prev );
 	int		GetFixedLen() { return fixedLen; }
 	void		Expand( const StrPtr &from, StrBuf &to, MapParams &p );
@@ -157,6 +167,7 @@ class MapHalf : public StrBuf {
 	void		FindParams( char *params, Error *e );
 
 	MapChar		*mapChar;	// compiled version 
+	MapHalfCompiled	*compiled;	// ... and faster, by Compile()
 	MapChar		*mapTail;	// non-wildcard tail start
 	MapChar		*mapEnd;	// non-wildcard tail end
 	int		fixedLen;	// How much until wildcard
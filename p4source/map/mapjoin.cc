@@ -24,6 +24,16 @@
 # include "mapdebug.h"
 # include "mapitem.h"
 
+# include <vector>
+# include <algorithm>
+
+# ifdef HAS_CPP11
+# include <atomic>
+# include <condition_variable>
+# include <mutex>
+# include <thread>
+# endif
+
 /*
  * mapFlagGrid -- how to combine two mapFlags
  */
@@ -40,6 +50,26 @@ MapFlag mapFlagGrid[6][6] = {
 
 } ;
 
+/*
+ * MapJoinRow - a row MapHalf::Join() produced, for JoinParallel()
+ * MapJoinBlock - the rows from joining one entry of m1
+ */
+
+struct MapJoinRow {
+	int		lhs;		// offsets into MapJoinBlock::text
+	int		lhsLen;
+	int		rhs;
+	int		rhsLen;
+	MapFlag		flag;
+	int		kept;		// by InsertNoDups() into the block's m0
+} ;
+
+struct MapJoinBlock {
+	StrBuf		text;
+	std::vector< MapJoinRow > rows;
+	int		bad;		// badJoin
+} ;
+
 class MapJoiner : public Joiner {
 
     public:
@@ -48,27 +78,71 @@ class MapJoiner : public Joiner {
 	{
 	    badJoin = 0;
 	    m0 = new MapTable;
+	    block = 0;
 	}
 
 	virtual	void Insert()
+	{
+	    Make();
+
+	    if( block )
+		Record();
+	    else
+		m0->InsertNoDups( newLhs, newRhs, mapFlag );
+	}
+
+	// Make() produces the new row; Clone() a joiner making the
+	// same rows, with its own m0, for a JoinParallel() worker.
+
+	virtual void Make()
 	{
 	    map->Lhs()->Expand( *this, newLhs, params );
 	    map->Rhs()->Expand( *this, newRhs, params );
-	    MapFlag mapFlag = mapFlagGrid[ map->Flag() ][ map2->Flag() ];
-	    m0->InsertNoDups( newLhs, newRhs, mapFlag );
+	    mapFlag = mapFlagGrid[ map->Flag() ][ map2->Flag() ];
 	}
 
+	virtual MapJoiner *Clone() { return new MapJoiner; }
+
+	void		Record();
+
     public:
 	MapTable *m0;
 
 	MapItem *map;
 	MapItem *map2;
 
+	MapJoinBlock *block;	// recording for JoinParallel()
+
     protected:
 	StrBuf newLhs;
 	StrBuf newRhs;
+	MapFlag mapFlag;
 } ;
 
+void
+MapJoiner::Record()
+{
+	MapJoinRow r;
+
+	r.lhs = block->text.Length();
+	r.lhsLen = newLhs.Length();
+	block->text.Append( &newLhs );
+	block->text.Extend( '\0' );
+
+	r.rhs = block->text.Length();
+	r.rhsLen = newRhs.Length();
+	block->text.Append( &newRhs );
+	block->text.Extend( '\0' );
+
+	r.flag = mapFlag;
+
+	int n = m0->Count();
+	m0->InsertNoDups( newLhs, newRhs, mapFlag );
+	r.kept = m0->Count() > n;
+
+	block->rows.push_back( r );
+}
+
 class MapJoiner2 : public MapJoiner {
 
     public:
@@ -81,13 +155,14 @@ class MapJoiner2 : public MapJoiner {
 	    this->dir2 = dir2;
 	}
 
-	virtual	void Insert()
+	virtual void Make()
 	{
 	    map->Ohs( dir1 )->Expand( *this, newLhs, params );
 	    map2->Ohs( dir2 )->Expand( *this, newRhs, params2 );
-	    MapFlag mapFlag = mapFlagGrid[ map->Flag() ][ map2->Flag() ];
-	    m0->InsertNoDups( newLhs, newRhs, mapFlag );
+	    mapFlag = mapFlagGrid[ map->Flag() ][ map2->Flag() ];
 	}
+
+	virtual MapJoiner *Clone() { return new MapJoiner2( dir1, dir2 ); }
 } ;
 
 void
@@ -124,6 +199,23 @@ MapTable::Join(
 	int m = max1 + m1->count + m2->count;
 	if( m > max2 ) m = max2;
 
+	// Big joins can be split across threads, except for stream
+	// views, where InsertNoDups() can change rows already kept.
+
+	int threads = p4tunable.Get( P4TUNE_MAP_JOIN_THREADS );
+
+# ifdef HAS_CPP11
+	if( threads > 1 && m1->count > 1 && !join2StreamViews )
+	{
+	    if( JoinParallel( m1, dir1, m2, dir2, j, m, threads ) )
+	    {
+		joinError = 1;
+		emptyReason = &MsgDb::TooWild;
+		return;
+	    }
+	}
+	else
+# endif
 	if( !m2->trees[ dir2 ].tree )
 	{	
 	  for(j->map = m1->entry; j->map && count<m; j->map = j->map->Next())
@@ -204,6 +296,238 @@ MapTable::Join(
 	    this->Dump( "map joined" );
 }
 
+/*
+ * MapTable::JoinParallel() - Join() on several threads
+ *
+ * Workers each take an entry of m1 and join it against m2, just as
+ * Join() does, recording the rows in a MapJoinBlock.  Each also puts
+ * the rows through InsertNoDups() into a table of its own, starting
+ * empty for each block, and notes which it kept.
+ *
+ * The calling thread then takes the blocks in m1's order.  The rows
+ * of each go through InsertNoDups() into this table until the last
+ * maxLookBack rows kept here are the last maxLookBack kept by the
+ * worker: those are all InsertNoDups() looks at, so from there on
+ * both keep the same rows, and the worker's choices are used without
+ * comparing.  The result is the same table Join() makes on its own,
+ * including where it stops for map.joinmax or a bad join.
+ *
+ * Workers stay within a few blocks of the merge, to bound memory.
+ * Returns 1 on a bad join.  Only with HAS_CPP11.
+ */
+
+# ifdef HAS_CPP11
+
+int
+MapTable::JoinParallel(
+	MapTable *m1, MapTableT dir1,
+	MapTable *m2, MapTableT dir2,
+	MapJoiner *j, int max, int threads )
+{
+	std::vector< MapItem * > items;
+
+	for( MapItem *i1 = m1->entry; i1; i1 = i1->Next() )
+	    items.push_back( i1 );
+
+	int n = items.size();
+	MapItem *tree2 = m2->trees[ dir2 ].tree;
+
+	std::vector< MapJoinBlock * > blocks( n, (MapJoinBlock *)0 );
+
+	// Join items[i] into a block, with joiner w.
+
+	auto work = [&]( MapJoiner *w, MapPairArray &pairs, int i )
+	{
+	    MapJoinBlock *b = new MapJoinBlock;
+	    b->bad = 0;
+
+	    w->block = b;
+	    w->badJoin = 0;
+	    w->m0->Clear();
+
+	    if( !tree2 )
+	    {
+		w->map = items[ i ];
+
+		for( w->map2 = m2->entry; w->map2; w->map2 = w->map2->Next() )
+		{
+		    w->map->Ths( dir1 )->Join( w->map2->Ths( dir2 ), *w );
+		    if( w->badJoin )
+		    {
+			b->bad = 1;
+			break;
+		    }
+		}
+	    }
+	    else
+	    {
+		pairs.Clear();
+		pairs.Match( items[ i ], tree2 );
+		pairs.Sort();
+
+		MapPair *jp;
+
+		for( int k = 0; ( jp = pairs.Get( k ) ); k++ )
+		{
+		    w->map = jp->item1;
+		    w->map2 = jp->tree2;
+		    jp->h1->Join( jp->h2, *w );
+		    delete jp;
+		}
+	    }
+
+	    return b;
+	};
+
+	// Put block b into this table.
+
+	auto merge = [&]( MapJoinBlock *b )
+	{
+	    // With no lookback every row is kept; with no limit on it
+	    // (< 0) they never get in step.
+
+	    int look = maxLookBack;
+	    std::vector< int > ours( look > 0 ? look : 0, -1 );
+	    std::vector< int > theirs( look > 0 ? look : 0, -1 );
+	    int o = 0, t = 0;
+	    int same = !look;
+
+	    for( size_t r = 0; r < b->rows.size(); r++ )
+	    {
+		MapJoinRow &row = b->rows[ r ];
+		StrRef lhs( b->text.Text() + row.lhs, row.lhsLen );
+		StrRef rhs( b->text.Text() + row.rhs, row.rhsLen );
+
+		if( same )
+		{
+		    if( row.kept )
+			Insert( lhs, rhs, row.flag );
+		    continue;
+		}
+
+		int c = count;
+		InsertNoDups( lhs, rhs, row.flag );
+
+		if( look < 0 )
+		    continue;
+
+		if( count > c )
+		    ours[ o++ % look ] = r;
+
+		if( row.kept )
+		    theirs[ t++ % look ] = r;
+
+		// Both have kept the same last few rows?
+
+		if( o >= look && t >= look )
+		{
+		    same = 1;
+		    for( int k = 1; same && k <= look; k++ )
+			same = ours[ ( o - k ) % look ] ==
+			       theirs[ ( t - k ) % look ];
+		}
+	    }
+	};
+
+	int bad = 0;
+
+	if( threads > n )
+	    threads = n;
+
+	std::mutex mu;
+	std::condition_variable cv;
+	int next = 0;
+	int merged = 0;
+	int stop = 0;
+	const int ahead = 4 * threads;
+
+	auto worker = [&]()
+	{
+	    MapJoiner *w = j->Clone();
+	    MapPairArray pairs( dir1, dir2 );
+
+	    if( caseMode == 0 || caseMode == 1 )
+		w->m0->SetCaseSensitivity( caseMode );
+	    w->m0->maxLookBack = maxLookBack;
+
+	    for( ;; )
+	    {
+		int i;
+
+		{
+		    std::unique_lock< std::mutex > lk( mu );
+		    cv.wait( lk, [&]{
+			return stop || next >= n || next < merged + ahead; } );
+
+		    if( stop || next >= n )
+			break;
+
+		    i = next++;
+		}
+
+		MapJoinBlock *b = work( w, pairs, i );
+
+		{
+		    std::lock_guard< std::mutex > lk( mu );
+		    blocks[ i ] = b;
+		}
+
+		cv.notify_all();
+	    }
+
+	    delete w->m0;
+	    delete w;
+	};
+
+	std::vector< std::thread > ts;
+	ts.reserve( threads );
+
+	for( int i = 0; i < threads; i++ )
+	    ts.emplace_back( worker );
+
+	// Merge in order, as they come.
+
+	for( int i = 0; i < n && count < max && !bad; i++ )
+	{
+	    MapJoinBlock *b;
+
+	    {
+		std::unique_lock< std::mutex > lk( mu );
+		cv.wait( lk, [&]{ return blocks[ i ] != 0; } );
+		b = blocks[ i ];
+		blocks[ i ] = 0;
+	    }
+
+	    merge( b );
+	    bad = b->bad;
+	    delete b;
+
+	    {
+		std::lock_guard< std::mutex > lk( mu );
+		merged = i + 1;
+	    }
+
+	    cv.notify_all();
+	}
+
+	{
+	    std::lock_guard< std::mutex > lk( mu );
+	    stop = 1;
+	}
+
+	cv.notify_all();
+
+	for( size_t i = 0; i < ts.size(); i++ )
+	    ts[i].join();
+
+	for( int i = 0; i < n; i++ )
+	    delete blocks[ i ];
+
+	return bad;
+}
+
+# endif
+
 MapTable *
 MapTable::Join( 
 	MapTableT dir1, 
@@ -311,6 +635,35 @@ MapTable::JoinCheck( MapTableT dir, MapTable *c, MapTableT dir2 )
  *		-a/d -b/d
  */
 
+static bool
+MapSlotAbove( MapItem *a, MapItem *b )
+{
+	return a->Slot() > b->Slot();
+}
+
+static void
+MapDisambiguateFind(
+	MapPairArray &pairs,
+	MapItem *map,
+	MapItem *tree,
+	std::vector< MapItem * > &found )
+{
+	// Entries above map whose fixed initial substring could
+	// match its own: MapHalf::Join() gives up on the rest.
+
+	pairs.Clear();
+	pairs.Match( map, tree );
+
+	MapPair *p;
+
+	for( int i = 0; ( p = pairs.Get( i ) ); i++ )
+	{
+	    if( p->tree2->Slot() > map->Slot() )
+		found.push_back( p->tree2 );
+	    delete p;
+	}
+}
+
 void
 MapTable::Disambiguate( int maxLookBack )
 {
@@ -319,10 +672,33 @@ MapTable::Disambiguate( int maxLookBack )
 	if( j.m0 )
 	    j.m0->SetMaxLookBack( maxLookBack );
 
+	// For all but small tables, use the LHS and RHS trees to find
+	// the higher precedence mappings each could overlap, rather
+	// than joining it with every one.  Andmaps are joined with
+	// themselves, so they are always tried.
+
+	const int indexed = count > 64;
+
+	MapPairArray lhsPairs( LHS, LHS );
+	MapPairArray rhsPairs( RHS, RHS );
+	std::vector< MapItem * > found;
+	std::vector< MapItem * > andmaps;
+
+	if( indexed )
+	{
+	    if( !trees[ LHS ].tree )
+		MakeTree( LHS );
+	    if( !trees[ RHS ].tree )
+		MakeTree( RHS );
+	}
+
 	// From high precendence to low precedence
 
 	for( j.map = this->entry; j.map; j.map = j.map->Next() )
 	{
+	    if( j.map->Flag() == MfAndmap )
+		andmaps.push_back( j.map );
+
 	    // We skip unmap lines, because we only need to
 	    // unmap to the extent that the unmap lines match lower
 	    // precedence map lines.  We do that below.
@@ -341,10 +717,33 @@ MapTable::Disambiguate( int maxLookBack )
 
 	    // From higher precedence back down to this mapping
 
-	    for( j.map2 = this->entry; 
-		 j.map2 != j.map;
-		 j.map2 = j.map2->Next() )
+	    found.clear();
+
+	    if( !indexed )
+	    {
+		for( j.map2 = this->entry; 
+		     j.map2 != j.map;
+		     j.map2 = j.map2->Next() )
+		    found.push_back( j.map2 );
+	    }
+	    else
 	    {
+		MapDisambiguateFind( lhsPairs, j.map, trees[ LHS ].tree, found );
+		MapDisambiguateFind( rhsPairs, j.map, trees[ RHS ].tree, found );
+
+		for( size_t i = 0; i < andmaps.size(); i++ )
+		    if( andmaps[ i ] != j.map )
+			found.push_back( andmaps[ i ] );
+
+		std::sort( found.begin(), found.end(), MapSlotAbove );
+		found.erase( std::unique( found.begin(), found.end() ),
+			     found.end() );
+	    }
+
+	    for( size_t i = 0; i < found.size(); i++ )
+	    {
+		j.map2 = found[ i ];
+
 		switch( j.map2->Flag() )
 		{
 		case MfRemap:
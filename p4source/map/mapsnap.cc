@@ -0,0 +1,540 @@
+/*
+ * Copyright 2024 Perforce Software.  All rights reserved.
+ *
+ * This file is part of Perforce - the FAST SCM System.
+ */
+
+//
+// mapsnap.cc - saving and loading MapTables, with their MapTrees
+//
+// A snapshot is the table's entries, in chain order, with the links
+// of both its MapTrees and its sorted arrays as entry numbers, then
+// the text of the entries.  Load() puts it back together without the
+// Disambiguate(), Sort() or MakeTree() that built it: all that's left
+// is making each MapHalf.
+//
+// Snapshots are in the machine's own byte order and int size, and
+// depend on how StrPtr compares case: the header records all three,
+// and Load() refuses a snapshot made differently.  It also refuses
+// one that fails its checksum, or whose links aren't trees.
+//
+
+# include <stdhdrs.h>
+# include <error.h>
+# include <strbuf.h>
+# include <vararray.h>
+# include <md5.h>
+# include <pathsys.h>
+# include <filesys.h>
+# include <readfile.h>
+
+# include <debug.h>
+# include <tunable.h>
+
+# include "maphalf.h"
+# include "maptable.h"
+# include "mapdebug.h"
+# include "mapitem.h"
+
+# include <map>
+# include <vector>
+
+# define MAPSNAP_MAGIC		"p4mapsnp"
+# define MAPSNAP_VERSION	1
+# define MAPSNAP_ORDER		0x01020304
+
+struct MapSnapHead {
+	char		magic[8];
+	int		version;
+	int		order;		// MAPSNAP_ORDER, as written
+	int		intSize;
+	int		caseUse;	// StrPtr::CaseFolding() etc.
+
+	int		count;
+	int		caseMode;
+	int		has;		// hasMaps, hasOverlays, ...
+	int		trees;		// 1 << dir for each MapTree
+	int		root[2];
+	int		depth[2];
+	int		textLen;
+	unsigned int	sum;		// of all that follows
+} ;
+
+struct MapSnapWhole {
+	int		left;		// entry numbers, or -1
+	int		center;
+	int		right;
+	int		maxSlot;
+	int		overlap;
+	int		hasands;
+	int		maxSlotNoAnds;
+} ;
+
+struct MapSnapItem {
+	int		flag;
+	int		slot;
+	int		lhs;		// offsets into the text
+	int		lhsLen;
+	int		rhs;
+	int		rhsLen;
+	MapSnapWhole	whole[2];
+} ;
+
+static unsigned int
+MapSnapSum( const char *p, const char *end )
+{
+	// FNV-1a
+
+	unsigned int h = 2166136261u;
+
+	while( p < end )
+	    h = ( h ^ (unsigned char)*p++ ) * 16777619u;
+
+	return h;
+}
+
+static int
+MapSnapFlag( int flag )
+{
+	// MapFlag has gaps: only its enumerators may be cast to it.
+
+	switch( flag )
+	{
+	case MfMap:
+	case MfUnmap:
+	case MfRemap:
+	case MfHavemap:
+	case MfChangemap:
+	case MfAndmap:
+	case MfStream1:
+	case MfStream2:
+	case MfStream3:
+	case MfStream5:
+	case MfStream6:
+	case MfStream7:
+	case MfStream8:
+	    return 1;
+
+	default:
+	    return 0;
+	}
+}
+
+static int
+MapSnapTree( const char *items, int count, int dir, int root )
+{
+	// Links that aren't a tree would have Match() going around in
+	// circles: every entry but the root must have exactly one
+	// parent, and be under the root.
+
+	std::vector< int > parents( count, 0 );
+	std::vector< int > stack;
+	MapSnapItem s;
+	int i, seen = 0;
+
+	for( i = 0; i < count; i++ )
+	{
+	    memcpy( &s, items + i * sizeof( s ), sizeof( s ) );
+
+	    MapSnapWhole *sw = &s.whole[ dir ];
+
+	    if( sw->left >= 0 ) ++parents[ sw->left ];
+	    if( sw->center >= 0 ) ++parents[ sw->center ];
+	    if( sw->right >= 0 ) ++parents[ sw->right ];
+	}
+
+	for( i = 0; i < count; i++ )
+	    if( parents[ i ] != ( i == root ? 0 : 1 ) )
+		return 0;
+
+	for( stack.push_back( root ); !stack.empty(); ++seen )
+	{
+	    memcpy( &s, items + stack.back() * sizeof( s ), sizeof( s ) );
+	    stack.pop_back();
+
+	    MapSnapWhole *sw = &s.whole[ dir ];
+
+	    if( sw->left >= 0 ) stack.push_back( sw->left );
+	    if( sw->center >= 0 ) stack.push_back( sw->center );
+	    if( sw->right >= 0 ) stack.push_back( sw->right );
+	}
+
+	return seen == count;
+}
+
+static int
+MapSnapCaseUse()
+{
+	return ( StrPtr::CaseFolding() ? 1 : 0 ) |
+	       ( StrPtr::CaseIgnored() ? 2 : 0 ) |
+	       ( StrPtr::CaseHybrid() ? 4 : 0 );
+}
+
+/*
+ * MapTable::Save() - append a snapshot of the table to out
+ */
+
+void
+MapTable::Save( StrBuf &out )
+{
+	// Both trees (and so both sorts), so the loaded
+	// table is ready to go either way.
+
+	MapSnapHead h;
+	memset( &h, 0, sizeof( h ) );
+	memcpy( h.magic, MAPSNAP_MAGIC, sizeof( h.magic ) );
+
+	h.version = MAPSNAP_VERSION;
+	h.order = MAPSNAP_ORDER;
+	h.intSize = sizeof( int );
+	h.caseUse = MapSnapCaseUse();
+	h.count = count;
+	h.caseMode = caseMode;
+	h.has = ( hasMaps ? 1 : 0 ) | ( hasOverlays ? 2 : 0 ) |
+		( hasHavemaps ? 4 : 0 ) | ( hasAndmaps ? 8 : 0 );
+
+	// Entry numbers, in chain order
+
+	std::map< MapItem *, int > number;
+	MapItem *map;
+	int i = 0;
+	int start = out.Length();
+
+	for( map = entry; map; map = map->Next() )
+	    number[ map ] = i++;
+
+	for( int dir = LHS; count && dir <= RHS; dir++ )
+	{
+	    if( !trees[ dir ].tree )
+		MakeTree( (MapTableT)dir );
+
+	    h.trees |= 1 << dir;
+	    h.root[ dir ] = number[ trees[ dir ].tree ];
+	    h.depth[ dir ] = trees[ dir ].depth;
+	}
+
+	for( map = entry; map; map = map->Next() )
+	    h.textLen += map->Lhs()->Length() + map->Rhs()->Length() + 2;
+
+	out.Append( (char *)&h, sizeof( h ) );
+
+	// The entries
+
+	int text = 0;
+
+	for( map = entry; map; map = map->Next() )
+	{
+	    MapSnapItem s;
+
+	    s.flag = map->Flag();
+	    s.slot = map->Slot();
+	    s.lhs = text;
+	    s.lhsLen = map->Lhs()->Length();
+	    s.rhs = s.lhs + s.lhsLen + 1;
+	    s.rhsLen = map->Rhs()->Length();
+	    text = s.rhs + s.rhsLen + 1;
+
+	    for( int dir = LHS; dir <= RHS; dir++ )
+	    {
+		MapItem::MapWhole *w = map->Whole( dir );
+		MapSnapWhole *sw = &s.whole[ dir ];
+
+		sw->left = w->left ? number[ w->left ] : -1;
+		sw->center = w->center ? number[ w->center ] : -1;
+		sw->right = w->right ? number[ w->right ] : -1;
+		sw->maxSlot = w->maxSlot;
+		sw->overlap = w->overlap;
+		sw->hasands = w->hasands;
+		sw->maxSlotNoAnds = w->maxSlotNoAnds;
+	    }
+
+	    out.Append( (char *)&s, sizeof( s ) );
+	}
+
+	// The sorts
+
+	for( int dir = LHS; dir <= RHS; dir++ )
+	{
+	    if( !( h.trees & ( 1 << dir ) ) )
+		continue;
+
+	    MapItem **vec = Sort( (MapTableT)dir );
+
+	    for( i = 0; i < count; i++ )
+	    {
+		int n = number[ vec[ i ] ];
+		out.Append( (char *)&n, sizeof( n ) );
+	    }
+	}
+
+	// The text, each null terminated
+
+	for( map = entry; map; map = map->Next() )
+	{
+	    out.Append( map->Lhs() );
+	    out.Extend( '\0' );
+	    out.Append( map->Rhs() );
+	    out.Extend( '\0' );
+	}
+
+	h.sum = MapSnapSum( out.Text() + start + sizeof( h ),
+			    out.Text() + out.Length() );
+
+	memcpy( out.Text() + start, &h, sizeof( h ) );
+}
+
+/*
+ * MapTable::Load() - replace the table with a snapshot from Save()
+ */
+
+int
+MapTable::Load( const StrPtr &snap )
+{
+	const char *p = snap.Text();
+	const char *end = p + snap.Length();
+
+	MapSnapHead h;
+
+	if( snap.Length() < (int)sizeof( h ) )
+	    return 0;
+
+	memcpy( &h, p, sizeof( h ) );
+	p += sizeof( h );
+
+	if( memcmp( h.magic, MAPSNAP_MAGIC, sizeof( h.magic ) ) ||
+	    h.version != MAPSNAP_VERSION ||
+	    h.order != MAPSNAP_ORDER ||
+	    h.intSize != (int)sizeof( int ) ||
+	    h.caseUse != MapSnapCaseUse() ||
+	    h.count < 0 || h.textLen < 0 )
+	    return 0;
+
+	// The sizes must add up to what's there, without overflowing.
+
+	int nTrees = ( h.trees & 1 ) + ( ( h.trees >> 1 ) & 1 );
+	size_t avail = end - p;
+	size_t per = sizeof( MapSnapItem ) + nTrees * sizeof( int );
+
+	if( (size_t)h.count > avail / per ||
+	    (size_t)h.textLen != avail - h.count * per ||
+	    h.sum != MapSnapSum( p, end ) )
+	    return 0;
+
+	const char *items = p;
+	const char *sorts = items + h.count * sizeof( MapSnapItem );
+	const char *text = sorts + nTrees * h.count * sizeof( int );
+
+	// Check it all, before we make anything.
+
+	MapSnapItem s;
+	int i, dir;
+
+	for( i = 0; i < h.count; i++ )
+	{
+	    memcpy( &s, items + i * sizeof( s ), sizeof( s ) );
+
+	    if( !MapSnapFlag( s.flag ) ||
+		s.lhs < 0 || s.lhs > h.textLen ||
+		s.lhsLen < 0 || s.lhsLen >= h.textLen - s.lhs ||
+		s.rhs < 0 || s.rhs > h.textLen ||
+		s.rhsLen < 0 || s.rhsLen >= h.textLen - s.rhs ||
+		text[ s.lhs + s.lhsLen ] || text[ s.rhs + s.rhsLen ] )
+		return 0;
+
+	    for( dir = LHS; dir <= RHS; dir++ )
+	    {
+		MapSnapWhole *sw = &s.whole[ dir ];
+
+		if( sw->left < -1 || sw->left >= h.count ||
+		    sw->center < -1 || sw->center >= h.count ||
+		    sw->right < -1 || sw->right >= h.count )
+		    return 0;
+	    }
+	}
+
+	for( dir = LHS; dir <= RHS; dir++ )
+	    if( ( h.trees & ( 1 << dir ) ) &&
+		( h.root[ dir ] < 0 || h.root[ dir ] >= h.count ||
+		  !MapSnapTree( items, h.count, dir, h.root[ dir ] ) ) )
+		return 0;
+
+	for( i = 0; i < nTrees * h.count; i++ )
+	{
+	    int n;
+	    memcpy( &n, sorts + i * sizeof( n ), sizeof( n ) );
+
+	    if( n < 0 || n >= h.count )
+		return 0;
+	}
+
+	// The entries, last first, to chain them.
+
+	Clear();
+
+	MapItem **vec = new MapItem *[ h.count + 1 ];
+	MapItem *next = 0;
+
+	for( i = h.count; i-- > 0; )
+	{
+	    memcpy( &s, items + i * sizeof( s ), sizeof( s ) );
+
+	    next = vec[ i ] = new MapItem( next,
+		    StrRef( (char *)text + s.lhs, s.lhsLen ),
+		    StrRef( (char *)text + s.rhs, s.rhsLen ),
+		    (MapFlag)s.flag, s.slot, h.caseMode );
+	}
+
+	entry = next;
+	count = h.count;
+	caseMode = h.caseMode;
+	hasMaps = ( h.has & 1 ) != 0;
+	hasOverlays = ( h.has & 2 ) != 0;
+	hasHavemaps = ( h.has & 4 ) != 0;
+	hasAndmaps = ( h.has & 8 ) != 0;
+
+	// The trees and sorts
+
+	const char *sort = sorts;
+
+	for( dir = LHS; dir <= RHS; dir++ )
+	{
+	    if( !( h.trees & ( 1 << dir ) ) )
+		continue;
+
+	    for( i = 0; i < h.count; i++ )
+	    {
+		memcpy( &s, items + i * sizeof( s ), sizeof( s ) );
+
+		MapSnapWhole *sw = &s.whole[ dir ];
+		MapItem::MapWhole *w = vec[ i ]->Whole( dir );
+
+		w->left = sw->left >= 0 ? vec[ sw->left ] : 0;
+		w->center = sw->center >= 0 ? vec[ sw->center ] : 0;
+		w->right = sw->right >= 0 ? vec[ sw->right ] : 0;
+		w->maxSlot = sw->maxSlot;
+		w->overlap = sw->overlap;
+		w->hasands = sw->hasands;
+		w->maxSlotNoAnds = sw->maxSlotNoAnds;
+
+		w->half.Compile();
+	    }
+
+	    MapItem **sorted = new MapItem *[ h.count ];
+
+	    for( i = 0; i < h.count; i++, sort += sizeof( int ) )
+	    {
+		int n;
+		memcpy( &n, sort, sizeof( n ) );
+		sorted[ i ] = vec[ n ];
+	    }
+
+	    trees[ dir ].sort = sorted;
+	    trees[ dir ].tree = vec[ h.root[ dir ] ];
+	    trees[ dir ].depth = h.depth[ dir ];
+	}
+
+	delete []vec;
+
+	return 1;
+}
+
+/*
+ * MapTable::SaveCache() - Save() to a file named for key, in dir
+ * MapTable::LoadCache() - Load() from the file SaveCache() wrote
+ *
+ * The name is the MD5 of the key and the table's case sensitivity,
+ * which Load() takes from the snapshot.
+ */
+
+static void
+MapSnapPath( const StrPtr &dir, const StrPtr &key, int caseMode, PathSys *path )
+{
+	MD5 md5;
+	StrBuf name;
+
+	name << caseMode << ":";
+
+	md5.Update( name );
+	md5.Update( key );
+	md5.Final( name );
+	name << ".map";
+
+	path->SetLocal( dir, name );
+}
+
+void
+MapTable::SaveCache( const StrPtr &dir, const StrPtr &key, Error *e )
+{
+	PathSys *path = PathSys::Create();
+	MapSnapPath( dir, key, caseMode, path );
+
+	StrBuf snap;
+	Save( snap );
+
+	// Write a temp file, and rename it into place, so that other
+	// processes see the whole snapshot or none.
+
+	FileSys *f = FileSys::Create( FST_BINARY );
+	FileSys *t = FileSys::Create( FST_BINARY );
+
+	f->Set( *path );
+	t->MakeLocalTemp( path->Text() );
+	t->SetDeleteOnClose();
+	t->Perms( FPM_RW );
+
+	t->Open( FOM_WRITE, e );
+
+	if( !e->Test() )
+	{
+	    t->Write( snap.Text(), snap.Length(), e );
+	    t->Close( e );
+	}
+
+	if( !e->Test() )
+	{
+	    t->Rename( f, e );
+
+	    if( !e->Test() )
+		t->ClearDeleteOnClose();
+	}
+
+	delete t;
+	delete f;
+	delete path;
+}
+
+int
+MapTable::LoadCache( const StrPtr &dir, const StrPtr &key, Error *e )
+{
+	PathSys *path = PathSys::Create();
+	MapSnapPath( dir, key, caseMode, path );
+
+	FileSys *f = FileSys::Create( FST_BINARY );
+	f->Set( *path );
+
+	int loaded = 0;
+
+	// Not there is just not cached.
+
+	if( f->Stat() & FSF_EXISTS )
+	{
+	    ReadFile r;
+
+	    r.Open( f, e );
+
+	    if( !e->Test() )
+	    {
+		r.Preload( r.Size() );
+
+		if( r.Avail() == r.Size() )
+		    loaded = Load( StrRef( (char *)r.Ptr(), r.Size() ) );
+
+		r.Close();
+	    }
+	}
+
+	delete f;
+	delete path;
+
+	return loaded;
+}
@@ -640,6 +640,11 @@ MapTable::MakeTree( MapTableT dir )
 
 	trees[ dir ].tree = MapItem::Tree( vec, vec + Count(), dir, 0, depth );
 	trees[ dir ].depth = depth;
+
+	// Translate() and friends Match2() against these halves.
+
+	for( MapItem *m = entry; m; m = m->Next() )
+	    m->Ths( dir )->Compile();
 }
 
 //
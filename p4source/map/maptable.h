@@ -89,6 +89,18 @@
  *		Returns 1 if lhs joined agains the dir of this MapTable 
  *		produces any rows, i.e. if this MapTable includes lhs.
  *
+ *	MapTable::Load( const StrPtr &snap )
+ *		Replaces the table with a snapshot made by Save(), trees
+ *		and all, without redoing Disambiguate() or MakeTree().
+ *		Returns 0 (leaving the table as it was) if snap is damaged
+ *		or was made on a different kind of machine.
+ *
+ *	MapTable::LoadCache( const StrPtr &dir, const StrPtr &key, Error *e )
+ *		Load()s the snapshot SaveCache() left in dir for key and
+ *		the table's case sensitivity.  Returns 0 if there is none
+ *		(or it won't load), setting e only if it is there but
+ *		can't be opened.
+ *
  *	MapTable::Match( char *lhs, char *from )
  *		Matches the pattern lhs against from.  Returns 1 on match
  *		and 0 on no match.  Cheesy access to MapHalf::Match().
@@ -103,6 +115,15 @@
  *		used by DbPipeMap* (if set) if the map is empty or filtered
  *		out all the incoming rows.
  *
+ *	MapTable::Save( StrBuf &out )
+ *		Appends a snapshot of the table, with both of its MapTrees,
+ *		to out.  The table should be disambiguated first.
+ *
+ *	MapTable::SaveCache( const StrPtr &dir, const StrPtr &key, Error *e )
+ *		Save()s the table to a file in dir named for key (which
+ *		should say everything the table was made from), for
+ *		LoadCache() in this or another process.
+ *
  *	MapTable::Strings( MapTableT direction )
  *		Returns a MapStrings object which contains sorted initial
  *		substrings for finding candidates pathnames that will map
@@ -118,6 +139,14 @@
  *		if nothing matches.  Direction is LHS (0) if 'from' 
  *		matches lhs, and RHS (1) if 'from' matches rhs.
  *
+ *	MapTable::TranslateMany( MapTableT dir, const StrPtr *from, int n,
+ *			StrBuf &to, int *offs, MapItem **maps )
+ *		Translate() for n paths, ideally sorted, using a
+ *		MapTranslator.  Each translation is appended to 'to', null
+ *		terminated, and offs[i] set to where it starts, or -1 if
+ *		from[i] doesn't map.  If maps is given, maps[i] is set to
+ *		the matching MapItem.  Returns the number that mapped.
+ *
  *	MapTable::Validate( char *lhs, char *rhs, Error *e )
  *		Verifies that a mapping has the same wildcards on both
  *		sides.
@@ -135,6 +164,7 @@ class MapTree;
 class MapHalf;
 class StrBuf;
 class MapItemArray;
+struct MapTransStep;
 
 enum MapTableT { 
 	LHS, 		// do operation on left-hand-side strings
@@ -206,17 +236,25 @@ class MapTable {
 	int		JoinCheck( MapTableT dir, const StrPtr &lhs );
 	int		JoinCheck( MapTableT dir, MapTable *c,
 			           MapTableT dir2 = LHS);
+	int		Load( const StrPtr &snap );
+	int		LoadCache( const StrPtr &dir, const StrPtr &key,
+			    Error *e );
 	static int 	Match( const StrPtr &lhs, const StrPtr &rhs );
 	static int 	Match( MapHalf *l, const StrPtr &rhs );
 	static int	ValidDepotMap( const StrPtr &map );
 	void		Remove( int slot );
 	void		Reverse();
+	void		Save( StrBuf &out );
+	void		SaveCache( const StrPtr &dir, const StrPtr &key,
+			    Error *e );
 	MapStrings *	Strings( MapTableT dir );
 	MapTable *	ConvertMap( MapFlag fromFlag, MapFlag toFlag );
 	MapTable *	StripMap( MapFlag mapFlag );
 	MapTable *	Swap( MapTable *m );
 	int		CountByFlag( MapFlag mapFlag );
 	MapItem *	Translate( MapTableT dir, const StrPtr &f, StrBuf &t );
+	int		TranslateMany( MapTableT dir, const StrPtr *f, int n,
+			    StrBuf &t, int *offs, MapItem **maps = 0 );
 	MapItemArray *	Explode( MapTableT dir, const StrPtr &f );
 	MapItemArray *	MatchAll( MapTableT dir, const StrPtr &f );
 	static void	Validate( const StrPtr &l, const StrPtr &r, Error *e );
@@ -261,9 +299,14 @@ class MapTable {
 
     private:
 
+	friend class MapTranslator;
+
 	void		Join( MapTable *m1, MapTableT dir1, 
 			      MapTable *m2, MapTableT dir2,
 			      MapJoiner *j, const ErrorId *reason );
+	int		JoinParallel( MapTable *m1, MapTableT dir1,
+			      MapTable *m2, MapTableT dir2,
+			      MapJoiner *j, int max, int threads );
 
 	// For building the string table for MapStrings and the
 	// MapTree for Match() and Translate().
@@ -293,3 +336,41 @@ class MapTable {
 	int		maxLookBack;	// for finding dups in InsertNoDups()
 
 } ;
+
+/*
+ * MapTranslator - translate a stream of paths through a MapTable
+ *
+ *	MapTranslator::Translate( const StrPtr &from, StrBuf &to )
+ *		As MapTable::Translate(), but remembers which way the last
+ *		path went down the MapTree.  The next path takes the same
+ *		branches without comparing, as far as they were decided by
+ *		the initial substring the two paths have in common, so a
+ *		sorted stream of paths (which share the most) goes fastest.
+ *		The MapTable must not change while the MapTranslator is
+ *		in use.
+ */
+
+class MapTranslator {
+
+    public:
+			MapTranslator( MapTable *table, MapTableT dir );
+			~MapTranslator();
+
+	MapItem *	Translate( const StrPtr &from, StrBuf &to );
+
+    private:
+
+	MapItem *	Match( const StrPtr &from, MapParams &params );
+
+	MapTable	*table;
+	MapTableT	dir;
+
+	// The last path and its steps down the tree
+
+	StrBuf		last;
+	MapItem		*root;
+	MapTransStep	*steps;
+	int		nSteps;
+	int		lastNeed;	// of the path, by the steps
+	int		candidates;	// steps that got to Match2()
+} ;
@@ -0,0 +1,233 @@
+/*
+ * Copyright 2024 Perforce Software.  All rights reserved.
+ *
+ * This file is part of Perforce - the FAST SCM System.
+ */
+
+//
+// maptrans.cc - translating streams of paths
+//
+// MapItem::Match() walks the MapTree from the root for each path,
+// using MapHalf::Match1() on the fixed (non-wildcard) initial part
+// of each entry to pick the left, center or right subtree.  Each of
+// those comparisons depends only on the first few characters of the
+// path: up to and including the first that differs, or the whole
+// fixed part if it matches.  If the next path agrees with the last
+// on at least that many characters, the comparison must come out the
+// same, so MapTranslator just replays it.  Only Match2(), the
+// wildcard part, always runs, and if the last path's walk had no
+// entries whose fixed part matched and the next path agrees with it
+// as far as the walk looked, it doesn't map either.
+//
+
+# include <stdhdrs.h>
+# include <error.h>
+# include <strbuf.h>
+# include <vararray.h>
+
+# include <debug.h>
+# include <tunable.h>
+
+# include "maphalf.h"
+# include "maptable.h"
+# include "mapdebug.h"
+# include "mapitem.h"
+
+struct MapTransStep {
+	MapItem		*tree;
+	int		r;	// Match1()
+	int		coff;	// ... and where it left off
+	int		need;	// how much of the path it depended on
+} ;
+
+MapTranslator::MapTranslator( MapTable *table, MapTableT dir )
+{
+	this->table = table;
+	this->dir = dir;
+	root = 0;
+	steps = 0;
+	nSteps = 0;
+	lastNeed = 0;
+	candidates = 0;
+}
+
+MapTranslator::~MapTranslator()
+{
+	delete []steps;
+}
+
+MapItem *
+MapTranslator::Match( const StrPtr &from, MapParams &params )
+{
+	if( !table->trees[ dir ].tree )
+	    table->MakeTree( dir );
+
+	MapItem *tree = table->trees[ dir ].tree;
+
+	// A new tree means the table changed (or we're new): forget.
+
+	if( tree != root )
+	{
+	    delete []steps;
+	    steps = new MapTransStep[ table->Count() + 1 ];
+	    root = tree;
+	    nSteps = 0;
+	}
+
+	// How much of this path is the same as the last?  We only keep
+	// as much of the last as its walk depended on.
+
+	int common = 0;
+	int len = from.Length() < last.Length() ? from.Length() : last.Length();
+
+	while( common < len && from.Text()[ common ] == last.Text()[ common ] )
+	    ++common;
+
+	if( !candidates && nSteps && common >= lastNeed )
+	    return 0;
+
+	// The descent of MapItem::Match(), less & maps.
+
+	int coff = 0;
+	int best = -1;
+	int bestnotands = -1;
+	int replay = nSteps;
+	int n = 0;
+	int need = 0;
+	MapItem *map = 0;
+	MapParams p;
+
+	candidates = 0;
+
+	while( tree )
+	{
+	    MapItem::MapWhole *t = tree->Whole( dir );
+
+	    if( best > t->maxSlot && bestnotands > t->maxSlotNoAnds )
+		break;
+
+	    if( coff > t->overlap )
+		coff = t->overlap;
+
+	    MapTransStep *s = &steps[ n ];
+
+	    if( n < replay && s->tree == tree && s->need <= common )
+	    {
+		coff = s->coff;
+	    }
+	    else
+	    {
+		// Off the last path's track: compare from here on.
+
+		replay = 0;
+		s->tree = tree;
+		s->r = 0;
+
+		if( coff < t->half.GetFixedLen() )
+		    s->r = t->half.Match1( from, coff );
+
+		s->coff = coff;
+
+		if( !s->r )
+		    s->need = coff;
+		else if( coff < from.Length() )
+		    s->need = coff + 1;
+		else
+		    s->need = from.Length() + 1;
+	    }
+
+	    ++n;
+
+	    if( need < s->need )
+		need = s->need;
+
+	    if( !s->r )
+		++candidates;
+
+	    if( !s->r &&
+		best < tree->slot &&
+		t->half.Match2( from, p ) )
+	    {
+		map = tree, best = map->slot;
+		bestnotands = tree->slot;
+		params = p;
+	    }
+
+	    if( s->r < 0 ) 	tree = t->left;
+	    else if( s->r > 0 ) tree = t->right;
+	    else 		tree = t->center;
+	}
+
+	nSteps = n;
+	lastNeed = need;
+	last.Set( from.Text(), need < from.Length() ? need : from.Length() );
+
+	if( !map || map->Flag() == MfUnmap )
+	    return 0;
+
+	return map;
+}
+
+MapItem *
+MapTranslator::Translate( const StrPtr &from, StrBuf &to )
+{
+	// & maps need the full MapItem::Match().
+
+	if( table->HasAndmaps() )
+	    return table->Translate( dir, from, to );
+
+	MapParams params;
+	MapItem *map = Match( from, params );
+
+	// Expand into target string, with the params of the match.
+
+	if( map )
+	{
+	    map->Ohs( dir )->Expand( from, to, params );
+
+	    if( DEBUG_TRANS )
+		p4debug.printf( "MapTrans: %s (%d) -> %s\n",
+		    from.Text(), map->Slot(), to.Text() );
+	}
+
+	return map;
+}
+
+//
+// MapTable::TranslateMany() - map many lhs's into rhs's
+//
+
+int
+MapTable::TranslateMany(
+	MapTableT dir,
+	const StrPtr *from,
+	int n,
+	StrBuf &to,
+	int *offs,
+	MapItem **maps )
+{
+	MapTranslator trans( this, dir );
+	StrBuf path;
+	int mapped = 0;
+
+	for( int i = 0; i < n; i++ )
+	{
+	    MapItem *map = trans.Translate( from[ i ], path );
+
+	    if( maps )
+		maps[ i ] = map;
+
+	    if( !map )
+	    {
+		offs[ i ] = -1;
+		continue;
+	    }
+
+	    offs[ i ] = to.Length();
+	    to.Append( &path );
+	    to.Extend( '\0' );
+	    ++mapped;
+	}
+
+	return mapped;
+}
@@ -22,7 +22,7 @@
  * When adding a new error make sure it's greater than the current high
  * value and update the following number:
  *
- * Current high value is: 494
+ * Current high value is: 503
  */
 
 //
@@ -523,6 +523,12 @@ R"(Maximum size a file revision allowed by '%'p4 annotate'%'.
 )"
 };
 
+ErrorId MsgConfig::DmAnnotateThreads = { ErrorOf( ES_CONFIG, 496, E_INFO, EV_NONE, 0 ),
+R"(The number of threads used to diff file revisions for '%'p4 annotate -I'%'.
+When set to 0 or 1, the revisions are diffed on a single thread.
+)"
+};
+
 ErrorId MsgConfig::DmBatchDomains = { ErrorOf( ES_CONFIG, 41, E_INFO, EV_NONE, 0 ),
 R"(Number of labels to process per lock on '%'db.label'%' when running '%'p4 labels'%'
 with filespec arguments. Values less than 1000 disable batching.
@@ -1186,6 +1192,21 @@ R"(When set to 1, the client will discard file content sent from the server.
 )"
 };
 
+ErrorId MsgConfig::FilesysClientWritebehind = { ErrorOf( ES_CONFIG, 499, E_INFO, EV_NONE, 0 ),
+R"(When set, the client writes file content sent from the server on a
+separate thread, so that receiving overlaps writing. The value is the
+most data, in bytes, queued for writing at once. When set to 0, file
+content is written as it is received.
+)"
+};
+
+ErrorId MsgConfig::FilesysScanThreads = { ErrorOf( ES_CONFIG, 495, E_INFO, EV_NONE, 0 ),
+R"(The number of threads the client uses to scan the workspace for
+'%'p4 reconcile'%' and '%'p4 status'%'. When set to 0 or 1, the workspace
+is scanned on a single thread.
+)"
+};
+
 ErrorId MsgConfig::IndexDomainOwner = { ErrorOf( ES_CONFIG, 140, E_INFO, EV_NONE, 0 ),
 R"(When enabled, the owner of clients/branches/labels/streams are indexed for
 faster lookup by owner.
@@ -1309,6 +1330,13 @@ client's IP address.
 )"
 };
 
+ErrorId MsgConfig::MapJoinThreads = { ErrorOf( ES_CONFIG, 503, E_INFO, EV_NONE, 0 ),
+R"(The number of threads used to join the lines of large maps, such as
+protections against a client or stream view.  When set to 0 or 1, maps
+are joined on a single thread.
+)"
+};
+
 ErrorId MsgConfig::MapJoinmax1 = { ErrorOf( ES_CONFIG, 160, E_INFO, EV_NONE, 0 ),
 R"(The maximum number of lines by which a joined map may exceed the sum of its
 input maps. Increasing this threshold beyond its default may result in server
@@ -1360,6 +1388,14 @@ R"(Network buffer size for sends.
 )"
 };
 
+ErrorId MsgConfig::NetCompressionCodec = { ErrorOf( ES_CONFIG, 498, E_INFO, EV_NONE, 0 ),
+R"(The codec for compressed client/server links: 0 for zlib, 1 for LZ4.
+LZ4 compresses less but is many times faster, for fast networks where
+zlib is the bottleneck. LZ4 is used only if both ends allow it; otherwise
+the link falls back to zlib.
+)"
+};
+
 ErrorId MsgConfig::NetDeltaTransferMinsize = { ErrorOf( ES_CONFIG, 487, E_INFO, EV_NONE, 0 ),
 R"(Minimum file size to perform a delta content transfer. A value of 0 disables
 delta content transfers.
@@ -1373,6 +1409,13 @@ transfers.
 )"
 };
 
+ErrorId MsgConfig::NetDeltaTransferThreads = { ErrorOf( ES_CONFIG, 497, E_INFO, EV_NONE, 0 ),
+R"(The number of threads used to find and hash the chunks of a large file
+for a delta content transfer. When set to 0 or 1, files are chunked on a
+single thread.
+)"
+};
+
 ErrorId MsgConfig::NetKeepaliveDisable = { ErrorOf( ES_CONFIG, 167, E_INFO, EV_NONE, 0 ),
 R"(If 0 and keepalive functionality is supported by the OS, keepalives are enabled
 on the socket. If 1, keepalives are disabled on the socket.
@@ -1515,6 +1558,14 @@ R"(Server-wide parallel sync transmit thread limit.
 )"
 };
 
+ErrorId MsgConfig::NetParallelPool = { ErrorOf( ES_CONFIG, 500, E_INFO, EV_NONE, 0 ),
+R"(The number of parallel sync, submit and shelve connections the client
+keeps open after a transfer, for use by the next transfer made from the
+same connection. When set to 0, each transfer's connections are closed
+when it completes.
+)"
+};
+
 ErrorId MsgConfig::NetRcvbuflowmark = { ErrorOf( ES_CONFIG, 192, E_INFO, EV_NONE, 0 ),
 R"(Used to manage dynamic '%'net.rcvbufsize'%' growth when autotuning.
 )"
@@ -1627,6 +1678,14 @@ differ in the end user's IP address.
 )"
 };
 
+ErrorId MsgConfig::RpcClientArena = { ErrorOf( ES_CONFIG, 502, E_INFO, EV_NONE, 0 ),
+R"(The block size of the arena from which the client allocates the file
+objects it uses while running a command. The arena is reused from one
+command to the next. When set to 0, the objects are allocated one at a
+time from the heap.
+)"
+};
+
 ErrorId MsgConfig::RplArchiveGraph = { ErrorOf( ES_CONFIG, 212, E_INFO, EV_NONE, 0 ),
 R"(Controls replication of graph depot archives:
 	0: Graph depot archives are not replicated
@@ -2488,6 +2547,13 @@ If '%'net.maxwait'%' is longer, '%'net.maxwait'%' is used instead.
 )"
 };
 
+ErrorId MsgConfig::SslClientSessionReuse = { ErrorOf( ES_CONFIG, 501, E_INFO, EV_NONE, 0 ),
+R"(When set to 1, a client making several connections to a server, such
+as for parallel sync or submit, resumes the TLS session of an earlier
+connection if the server allows it, instead of a full handshake.
+)"
+};
+
 ErrorId MsgConfig::SslClientTlsVersionMin = { ErrorOf( ES_CONFIG, 337, E_INFO, EV_NONE, 0 ),
 R"(Minimum TLS version to use for client connections, including those made by
 servers. Valid values are:
@@ -102,6 +102,7 @@ class MsgConfig {
 	static ErrorId DiffSthresh;
 	static ErrorId DmAltsyncEnforce;
 	static ErrorId DmAnnotateMaxsize;
+	static ErrorId DmAnnotateThreads;
 	static ErrorId DmBatchDomains;
 	static ErrorId DmBatchNet;
 	static ErrorId DmChangeRestrictPending;
@@ -207,6 +208,8 @@ class MsgConfig {
 	static ErrorId FilesysExtendlowmark;
 	static ErrorId FilesysWindowsLfn;
 	static ErrorId FilesysClientNullsync;
+	static ErrorId FilesysClientWritebehind;
+	static ErrorId FilesysScanThreads;
 	static ErrorId IndexDomainOwner;
 	static ErrorId LbrAutocompress;
 	static ErrorId LbrBufsize;
@@ -227,6 +230,7 @@ class MsgConfig {
 	static ErrorId LbrRcsLocking;
 	static ErrorId LogGroupMaxlen;
 	static ErrorId LogOriginhost;
+	static ErrorId MapJoinThreads;
 	static ErrorId MapJoinmax1;
 	static ErrorId MapJoinmax2;
 	static ErrorId MapLimitMaxlookback;
@@ -235,8 +239,10 @@ class MsgConfig {
 	static ErrorId MergeDlEndeol;
 	static ErrorId NetAutotune;
 	static ErrorId NetBufsize;
+	static ErrorId NetCompressionCodec;
 	static ErrorId NetDeltaTransferMinsize;
 	static ErrorId NetDeltaTransferThreshold;
+	static ErrorId NetDeltaTransferThreads;
 	static ErrorId NetKeepaliveDisable;
 	static ErrorId NetKeepaliveIdle;
 	static ErrorId NetKeepaliveInterval;
@@ -262,6 +268,7 @@ class MsgConfig {
 	static ErrorId NetParallelSubmitBatch;
 	static ErrorId NetParallelSubmitMin;
 	static ErrorId NetParallelSyncSvrthreads;
+	static ErrorId NetParallelPool;
 	static ErrorId NetRcvbuflowmark;
 	static ErrorId NetRcvbufmaxsize;
 	static ErrorId NetRcvbufsize;
@@ -283,6 +290,7 @@ class MsgConfig {
 	static ErrorId RpcHimark;
 	static ErrorId RpcLowmark;
 	static ErrorId RpcIpaddrMismatch;
+	static ErrorId RpcClientArena;
 	static ErrorId RplArchiveGraph;
 	static ErrorId RplAwaitjnlCount;
 	static ErrorId RplAwaitjnlInterval;
@@ -416,6 +424,7 @@ class MsgConfig {
 	static ErrorId RplPullReload;
 	static ErrorId SslSecondarySuite;
 	static ErrorId SslClientTimeout;
+	static ErrorId SslClientSessionReuse;
 	static ErrorId SslClientTlsVersionMin;
 	static ErrorId SslClientTlsVersionMax;
 	static ErrorId SslClientTrustName;
@@ -109,6 +109,7 @@ ErrorId MsgConfig::DiffSlimit2 = { ErrorOf( ES_CONFIG, 37, E_INFO, EV_NONE, 0),
 ErrorId MsgConfig::DiffSthresh = { ErrorOf( ES_CONFIG, 38, E_INFO, EV_NONE, 0), "MsgConfig::DiffSthresh placeholder." };
 ErrorId MsgConfig::DmAltsyncEnforce = { ErrorOf( ES_CONFIG, 39, E_INFO, EV_NONE, 0), "MsgConfig::DmAltsyncEnforce placeholder." };
 ErrorId MsgConfig::DmAnnotateMaxsize = { ErrorOf( ES_CONFIG, 40, E_INFO, EV_NONE, 0), "MsgConfig::DmAnnotateMaxsize placeholder." };
+ErrorId MsgConfig::DmAnnotateThreads = { ErrorOf( ES_CONFIG, 496, E_INFO, EV_NONE, 0), "MsgConfig::DmAnnotateThreads placeholder." };
 ErrorId MsgConfig::DmBatchDomains = { ErrorOf( ES_CONFIG, 41, E_INFO, EV_NONE, 0), "MsgConfig::DmBatchDomains placeholder." };
 ErrorId MsgConfig::DmBatchNet = { ErrorOf( ES_CONFIG, 42, E_INFO, EV_NONE, 0), "MsgConfig::DmBatchNet placeholder." };
 ErrorId MsgConfig::DmChangeRestrictPending = { ErrorOf( ES_CONFIG, 43, E_INFO, EV_NONE, 0), "MsgConfig::DmChangeRestrictPending placeholder." };
@@ -214,6 +215,8 @@ ErrorId MsgConfig::FilesysUtf8Bom = { ErrorOf( ES_CONFIG, 136, E_INFO, EV_NONE,
 ErrorId MsgConfig::FilesysExtendlowmark = { ErrorOf( ES_CONFIG, 137, E_INFO, EV_NONE, 0), "MsgConfig::FilesysExtendlowmark placeholder." };
 ErrorId MsgConfig::FilesysWindowsLfn = { ErrorOf( ES_CONFIG, 138, E_INFO, EV_NONE, 0), "MsgConfig::FilesysWindowsLfn placeholder." };
 ErrorId MsgConfig::FilesysClientNullsync = { ErrorOf( ES_CONFIG, 139, E_INFO, EV_NONE, 0), "MsgConfig::FilesysClientNullsync placeholder." };
+ErrorId MsgConfig::FilesysClientWritebehind = { ErrorOf( ES_CONFIG, 499, E_INFO, EV_NONE, 0), "MsgConfig::FilesysClientWritebehind placeholder." };
+ErrorId MsgConfig::FilesysScanThreads = { ErrorOf( ES_CONFIG, 495, E_INFO, EV_NONE, 0), "MsgConfig::FilesysScanThreads placeholder." };
 ErrorId MsgConfig::IndexDomainOwner = { ErrorOf( ES_CONFIG, 140, E_INFO, EV_NONE, 0), "MsgConfig::IndexDomainOwner placeholder." };
 ErrorId MsgConfig::LbrAutocompress = { ErrorOf( ES_CONFIG, 141, E_INFO, EV_NONE, 0), "MsgConfig::LbrAutocompress placeholder." };
 ErrorId MsgConfig::LbrBufsize = { ErrorOf( ES_CONFIG, 142, E_INFO, EV_NONE, 0), "MsgConfig::LbrBufsize placeholder." };
@@ -235,6 +238,7 @@ ErrorId MsgConfig::LbrStorageThreads = { ErrorOf( ES_CONFIG, 156, E_INFO, EV_NON
 ErrorId MsgConfig::LbrRcsLocking = { ErrorOf( ES_CONFIG, 157, E_INFO, EV_NONE, 0), "MsgConfig::LbrRcsLocking placeholder." };
 ErrorId MsgConfig::LogGroupMaxlen = { ErrorOf( ES_CONFIG, 158, E_INFO, EV_NONE, 0), "MsgConfig::LogGroupMaxlen placeholder." };
 ErrorId MsgConfig::LogOriginhost = { ErrorOf( ES_CONFIG, 159, E_INFO, EV_NONE, 0), "MsgConfig::LogOriginhost placeholder." };
+ErrorId MsgConfig::MapJoinThreads = { ErrorOf( ES_CONFIG, 503, E_INFO, EV_NONE, 0), "MsgConfig::MapJoinThreads placeholder." };
 ErrorId MsgConfig::MapJoinmax1 = { ErrorOf( ES_CONFIG, 160, E_INFO, EV_NONE, 0), "MsgConfig::MapJoinmax1 placeholder." };
 ErrorId MsgConfig::MapJoinmax2 = { ErrorOf( ES_CONFIG, 161, E_INFO, EV_NONE, 0), "MsgConfig::MapJoinmax2 placeholder." };
 ErrorId MsgConfig::MapLimitMaxlookback = { ErrorOf( ES_CONFIG, 477, E_INFO, EV_NONE, 0), "MsgConfig::MapLimitMaxlookback placeholder." };
@@ -243,8 +247,10 @@ ErrorId MsgConfig::MapOverlayLegacy = { ErrorOf( ES_CONFIG, 163, E_INFO, EV_NONE
 ErrorId MsgConfig::MergeDlEndeol = { ErrorOf( ES_CONFIG, 164, E_INFO, EV_NONE, 0), "MsgConfig::MergeDlEndeol placeholder." };
 ErrorId MsgConfig::NetAutotune = { ErrorOf( ES_CONFIG, 165, E_INFO, EV_NONE, 0), "MsgConfig::NetAutotune placeholder." };
 ErrorId MsgConfig::NetBufsize = { ErrorOf( ES_CONFIG, 166, E_INFO, EV_NONE, 0), "MsgConfig::NetBufsize placeholder." };
+ErrorId MsgConfig::NetCompressionCodec = { ErrorOf( ES_CONFIG, 498, E_INFO, EV_NONE, 0), "MsgConfig::NetCompressionCodec placeholder." };
 ErrorId MsgConfig::NetDeltaTransferMinsize = { ErrorOf( ES_CONFIG, 487, E_INFO, EV_NONE, 0), "MsgConfig::NetDeltaTransferMinsize placeholder." };
 ErrorId MsgConfig::NetDeltaTransferThreshold = { ErrorOf( ES_CONFIG, 488, E_INFO, EV_NONE, 0), "MsgConfig::NetDeltaTransferThreshold placeholder." };
+ErrorId MsgConfig::NetDeltaTransferThreads = { ErrorOf( ES_CONFIG, 497, E_INFO, EV_NONE, 0), "MsgConfig::NetDeltaTransferThreads placeholder." };
 ErrorId MsgConfig::NetKeepaliveDisable = { ErrorOf( ES_CONFIG, 167, E_INFO, EV_NONE, 0), "MsgConfig::NetKeepaliveDisable placeholder." };
 ErrorId MsgConfig::NetKeepaliveIdle = { ErrorOf( ES_CONFIG, 168, E_INFO, EV_NONE, 0), "MsgConfig::NetKeepaliveIdle placeholder." };
 ErrorId MsgConfig::NetKeepaliveInterval = { ErrorOf( ES_CONFIG, 169, E_INFO, EV_NONE, 0), "MsgConfig::NetKeepaliveInterval placeholder." };
@@ -270,6 +276,7 @@ ErrorId MsgConfig::NetParallelSubmitThreads = { ErrorOf( ES_CONFIG, 188, E_INFO,
 ErrorId MsgConfig::NetParallelSubmitBatch = { ErrorOf( ES_CONFIG, 189, E_INFO, EV_NONE, 0), "MsgConfig::NetParallelSubmitBatch placeholder." };
 ErrorId MsgConfig::NetParallelSubmitMin = { ErrorOf( ES_CONFIG, 190, E_INFO, EV_NONE, 0), "MsgConfig::NetParallelSubmitMin placeholder." };
 ErrorId MsgConfig::NetParallelSyncSvrthreads = { ErrorOf( ES_CONFIG, 191, E_INFO, EV_NONE, 0), "MsgConfig::NetParallelSyncSvrthreads placeholder." };
+ErrorId MsgConfig::NetParallelPool = { ErrorOf( ES_CONFIG, 500, E_INFO, EV_NONE, 0), "MsgConfig::NetParallelPool placeholder." };
 ErrorId MsgConfig::NetRcvbuflowmark = { ErrorOf( ES_CONFIG, 192, E_INFO, EV_NONE, 0), "MsgConfig::NetRcvbuflowmark placeholder." };
 ErrorId MsgConfig::NetRcvbufmaxsize = { ErrorOf( ES_CONFIG, 193, E_INFO, EV_NONE, 0), "MsgConfig::NetRcvbufmaxsize placeholder." };
 ErrorId MsgConfig::NetRcvbufsize = { ErrorOf( ES_CONFIG, 194, E_INFO, EV_NONE, 0), "MsgConfig::NetRcvbufsize placeholder." };
@@ -291,6 +298,7 @@ ErrorId MsgConfig::RpcDurablewait = { ErrorOf( ES_CONFIG, 208, E_INFO, EV_NONE,
 ErrorId MsgConfig::RpcHimark = { ErrorOf( ES_CONFIG, 209, E_INFO, EV_NONE, 0), "MsgConfig::RpcHimark placeholder." };
 ErrorId MsgConfig::RpcLowmark = { ErrorOf( ES_CONFIG, 210, E_INFO, EV_NONE, 0), "MsgConfig::RpcLowmark placeholder." };
 ErrorId MsgConfig::RpcIpaddrMismatch = { ErrorOf( ES_CONFIG, 211, E_INFO, EV_NONE, 0), "MsgConfig::RpcIpaddrMismatch placeholder." };
+ErrorId MsgConfig::RpcClientArena = { ErrorOf( ES_CONFIG, 502, E_INFO, EV_NONE, 0), "MsgConfig::RpcClientArena placeholder." };
 ErrorId MsgConfig::RplArchiveGraph = { ErrorOf( ES_CONFIG, 212, E_INFO, EV_NONE, 0), "MsgConfig::RplArchiveGraph placeholder." };
 ErrorId MsgConfig::RplAwaitjnlCount = { ErrorOf( ES_CONFIG, 213, E_INFO, EV_NONE, 0), "MsgConfig::RplAwaitjnlCount placeholder." };
 ErrorId MsgConfig::RplAwaitjnlInterval = { ErrorOf( ES_CONFIG, 214, E_INFO, EV_NONE, 0), "MsgConfig::RplAwaitjnlInterval placeholder." };
@@ -419,6 +427,7 @@ ErrorId MsgConfig::RplPullPosition = { ErrorOf( ES_CONFIG, 333, E_INFO, EV_NONE,
 ErrorId MsgConfig::RplPullReload = { ErrorOf( ES_CONFIG, 334, E_INFO, EV_NONE, 0), "MsgConfig::RplPullReload placeholder." };
 ErrorId MsgConfig::SslSecondarySuite = { ErrorOf( ES_CONFIG, 335, E_INFO, EV_NONE, 0), "MsgConfig::SslSecondarySuite placeholder." };
 ErrorId MsgConfig::SslClientTimeout = { ErrorOf( ES_CONFIG, 336, E_INFO, EV_NONE, 0), "MsgConfig::SslClientTimeout placeholder." };
+ErrorId MsgConfig::SslClientSessionReuse = { ErrorOf( ES_CONFIG, 501, E_INFO, EV_NONE, 0), "MsgConfig::SslClientSessionReuse placeholder." };
 ErrorId MsgConfig::SslClientTlsVersionMin = { ErrorOf( ES_CONFIG, 337, E_INFO, EV_NONE, 0), "MsgConfig::SslClientTlsVersionMin placeholder." };
 ErrorId MsgConfig::SslClientTlsVersionMax = { ErrorOf( ES_CONFIG, 338, E_INFO, EV_NONE, 0), "MsgConfig::SslClientTlsVersionMax placeholder." };
 ErrorId MsgConfig::SslClientTrustName = { ErrorOf( ES_CONFIG, 339, E_INFO, EV_NONE, 0), "MsgConfig::SslClientTrustName placeholder." };
@@ -990,6 +990,7 @@ R"(
 	diff.slimit1           10M Longest diff snake; smaller is faster
 	diff.slimit2          100M Longest diff snake for smaller files
 	diff.sthresh           50K Use slimit2 if lines to diff < sthresh
+	dm.annotate.threads      0 Threads used to diff for annotate -I
 	dm.batch.domains         0 'labels path' scan in label intervals
 	dm.change.restrict.pending
 	                         0 Description for pending restricted changes
@@ -1041,21 +1042,29 @@ R"(
 	dm.revcx.thresh2        1K ...of thresh1+thresh2 rows match path
 	dm.user.insecurelogin    0 issue login tickets that work on all hosts
 	filesys.cachehint        0 preserve buffer cache for db files (linux)
+	filesys.client.writebehind 0 Bytes queued to write files behind sync
 	filesys.maketmp         10 Max attempts to find unused temp name
 	filesys.maxmap       1000M Use read rather than mmapping big files
 	filesys.maxsymlink      1K Symlink maximum content length
 	filesys.maxtmp          1M Rollover for creating temp file names
+	filesys.scan.threads     0 Threads used to scan workspace (reconcile)
 	filesys.windows.lfn      1 Enable Windows filename > 260 characters
+	map.join.threads         0 Threads used to join large maps
 	map.joinmax1           10K Produce at most map1+map2+joinmax1
 	map.joinmax2            1M Produce at most joinmax2
 	map.maxwild             10 Maximum number of wildcards per line
 	map.overlay.legacy       0 See 'Overlay mapping legacy behavior' above
 	net.bufsize             4K Network I/O buffer size
+	net.compression.codec    0 Link compression: 0 zlib, 1 LZ4
+	net.delta.transfer.threads
+	                         0 Threads used to chunk large files
+	net.parallel.pool        0 Parallel transfer connections kept open
 	proxy.deliver.fix	 1 Enable fix for proxy hang
 	rcs.maxinsert           1G Max lines in RCS archive file
 	rpc.himark            2000 Max outstanding data between server/client
 	rpc.lowmark            700 Interval for checking outstanding data
 	rpc.ipaddr.mismatch      1 Check for client address mismatch
+	rpc.client.arena         0 Client file object arena block size
 	rpl.awaitjnl.count     100 Max count of waits for journal data (-i 0)
 	rpl.awaitjnl.interval   50 Millisecs to wait for journal data (-i 0)
 	rpl.journal.ack          0 In DCS, number of ACKs requested
@@ -1065,6 +1074,8 @@ R"(
 	serverlog.name.N      none Alias name for this log file
 	serverlog.events.N    none Events that should write to this log
 	spec.custom              0 If > 0 allow modifications to spec forms.
+	ssl.client.session.reuse
+	                         0 Resume TLS sessions on parallel connects
 	submit.forcenoretransfer 0 Allow submit --forcenoretransfer option
 	switch.stream.unrelated  0 If 1 can switch to another stream hierarchy
 	sys.rename.max          10 Limit for retrying a failed file rename
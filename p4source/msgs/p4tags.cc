@@ -283,6 +283,7 @@ const char P4Tag::v_lfmt[] = "lfmt";
 const char P4Tag::v_limitMap[] = "limitMap";
 const char P4Tag::v_line[] = "line";
 const char P4Tag::v_lineEnd[] = "lineEnd";
+const char P4Tag::v_linkCodec[] = "linkCodec";
 const char P4Tag::v_locale[] = "locale";
 const char P4Tag::v_lower[] = "lower";
 const char P4Tag::v_lockGlobal[] = "lockGlobal";
@@ -300,6 +300,7 @@ struct P4Tag {
 	static const char v_limitMap[];
 	static const char v_line[];
 	static const char v_lineEnd[];
+	static const char v_linkCodec[];
 	static const char v_locale[];
 	static const char v_lower[];
 	static const char v_lockGlobal[];
@@ -18,6 +18,7 @@
 
 # include <zlib.h>
 # include <zutil.h>
+# include <lz4.h>
 # include <msgsupp.h>
 
 # include <keepalive.h>
@@ -30,6 +31,206 @@
 extern "C" void* P4_zalloc( void* opaque, unsigned items, unsigned size );
 extern "C" void P4_zfree( void* opaque, void* ptr );
 
+/*
+ * NetLz4 - one half of an LZ4 compressed link
+ *
+ *	The stream is a run of frames, each up to 64K of data.  A frame
+ *	has a 4 byte header: the length of what follows (low 3 bytes)
+ *	and its type (high byte): an LZ4 block, or the data as-is when
+ *	it wouldn't shrink.
+ *
+ *	Sending, Stage() gathers data until a block is full, or until
+ *	Pack() is called by Flush(); the frame is then taken out into
+ *	the send buffer as room allows.
+ *
+ *	Receiving, Unpack() decodes a frame straight from the receive
+ *	buffer if it's all there, otherwise gathering it first.  The
+ *	decoded data is then taken out by Receive().
+ */
+
+class NetLz4 {
+
+    public:
+			NetLz4( int sending );
+
+	int		Stage( const char *p, int n );
+	void		Pack();
+	int		Staged() { return inLen; }
+
+	int		Unpack( const char *p, int n );
+
+	int		Pending() { return outEnd - outPtr; }
+	int		Take( char *p, int n );
+
+    private:
+
+	enum { BlockSize = 65536, HeaderSize = 4 };
+	enum { FrameLz4, FrameStored };
+
+	int		FrameLength( const char *h );
+	int		Decode( const char *frame, int len );
+
+	StrBuf		in;		// staged data; partial frame
+	int		inLen;
+
+	StrBuf		out;		// frame to send; decoded data
+	char		*outPtr;
+	char		*outEnd;
+} ;
+
+NetLz4::NetLz4( int sending )
+{
+	int frameSize = HeaderSize + LZ4_compressBound( BlockSize );
+
+	in.Alloc( sending ? BlockSize : frameSize );
+	out.Alloc( sending ? frameSize : BlockSize );
+	inLen = 0;
+	outPtr = outEnd = out.Text();
+}
+
+int
+NetLz4::Stage( const char *p, int n )
+{
+	if( n > BlockSize - inLen )
+	    n = BlockSize - inLen;
+
+	memcpy( in.Text() + inLen, p, n );
+	inLen += n;
+
+	if( inLen == BlockSize )
+	    Pack();
+
+	return n;
+}
+
+void
+NetLz4::Pack()
+{
+	if( !inLen )
+	    return;
+
+	// Compress, unless it doesn't come out smaller.
+
+	char *f = out.Text();
+	int type = FrameLz4;
+	int n = LZ4_compress_default( in.Text(), f + HeaderSize,
+			inLen, inLen - 1 );
+
+	if( n <= 0 )
+	{
+	    memcpy( f + HeaderSize, in.Text(), inLen );
+	    n = inLen;
+	    type = FrameStored;
+	}
+
+	f[0] = (char)( n );
+	f[1] = (char)( n >> 8 );
+	f[2] = (char)( n >> 16 );
+	f[3] = (char)( type );
+
+	outPtr = f;
+	outEnd = f + HeaderSize + n;
+	inLen = 0;
+}
+
+int
+NetLz4::FrameLength( const char *h )
+{
+	const unsigned char *u = (const unsigned char *)h;
+	int len = u[0] | ( u[1] << 8 ) | ( u[2] << 16 );
+
+	switch( u[3] )
+	{
+	case FrameLz4:
+	    return len && len <= LZ4_compressBound( BlockSize ) ? len : -1;
+	case FrameStored:
+	    return len && len <= BlockSize ? len : -1;
+	default:
+	    return -1;
+	}
+}
+
+int
+NetLz4::Decode( const char *frame, int len )
+{
+	int n = len;
+
+	if( frame[3] == FrameStored )
+	    memcpy( out.Text(), frame + HeaderSize, len );
+	else
+	    n = LZ4_decompress_safe( frame + HeaderSize, out.Text(),
+				len, BlockSize );
+
+	outPtr = out.Text();
+	outEnd = out.Text() + ( n > 0 ? n : 0 );
+
+	return n > 0;
+}
+
+int
+NetLz4::Unpack( const char *p, int n )
+{
+	// Returns what was used of p[n], or -1 for a bad frame.
+
+	if( !inLen && n >= HeaderSize )
+	{
+	    int len = FrameLength( p );
+
+	    if( len < 0 )
+		return -1;
+
+	    if( n >= HeaderSize + len )
+		return Decode( p, len ) ? HeaderSize + len : -1;
+	}
+
+	// Not all there: gather the header, then the rest.
+
+	int used = 0;
+
+	while( used < n )
+	{
+	    int want = HeaderSize;
+
+	    if( inLen >= HeaderSize )
+	    {
+		int len = FrameLength( in.Text() );
+
+		if( len < 0 )
+		    return -1;
+
+		want += len;
+	    }
+
+	    int l = want - inLen;
+	    if( l > n - used )
+		l = n - used;
+
+	    memcpy( in.Text() + inLen, p + used, l );
+	    inLen += l;
+	    used += l;
+
+	    if( inLen == want && want > HeaderSize )
+	    {
+		inLen = 0;
+		return Decode( in.Text(), want - HeaderSize ) ? used : -1;
+	    }
+	}
+
+	return used;
+}
+
+int
+NetLz4::Take( char *p, int n )
+{
+	if( n > Pending() )
+	    n = Pending();
+
+	memcpy( p, outPtr, n );
+	outPtr += n;
+
+	return n;
+}
+
 NetBuffer::NetBuffer( NetTransport *t )
 {
 	int size = p4tunable.Get( P4TUNE_NET_BUFSIZE );
@@ -43,6 +244,8 @@ NetBuffer::NetBuffer( NetTransport *t )
 
 	zin = 0;
 	zout = 0;
+	lzin = 0;
+	lzout = 0;
 	compressing = 0;
 
 	transport = t;
@@ -54,6 +257,8 @@ NetBuffer::~NetBuffer()
 	if( zout ) deflateEnd( zout );
 	delete zin;
 	delete zout;
+	delete lzin;
+	delete lzout;
 	delete transport;
 }
 
@@ -63,7 +268,7 @@ NetBuffer::SetBufferSizes( int recvSize, int sendSize )
 	// Remember offsets
 
 	int recvDone = RecvDone();
-	int recvReady = RecvReady();
+	int recvReady = RecvBuffered();
 	int sendDone = SendDone();
 	int sendReady = SendReady();
 
@@ -114,7 +319,7 @@ NetBuffer::ResizeBuffer()
 
 	// Remember offsets
 	int recvDone = RecvDone();
-	int recvReady = RecvReady();
+	int recvReady = RecvBuffered();
 
 	// Increase buffer size
 	recvBuf.BlockAlloc( growSize );
@@ -129,13 +334,26 @@ NetBuffer::ResizeBuffer()
 }
 
 void
-NetBuffer::SendCompression( Error *e )
+NetBuffer::SendCompression( Error *e, int codec )
 {
 	// Sanity!
 	// Don't let it be turned on twice.
 
-	if( zout )
+	if( zout || lzout )
+	    return;
+
+	if( codec == NET_CODEC_LZ4 )
+	{
+	    DEBUGPRINT( DEBUG_TRANS, "NetBuffer send compressing (lz4)" );
+	    lzout = new NetLz4( 1 );
+	    return;
+	}
+
+	if( codec != NET_CODEC_ZLIB )
+	{
+	    e->Set( MsgSupp::DeflateInit );
 	    return;
+	}
 
 	DEBUGPRINT( DEBUG_TRANS, "NetBuffer send compressing" );
 
@@ -159,13 +377,26 @@ NetBuffer::SendCompression( Error *e )
 }
 
 void
-NetBuffer::RecvCompression( Error *e )
+NetBuffer::RecvCompression( Error *e, int codec )
 {
 	// Sanity!
 	// Don't let it be turned on twice.
 
-	if( zin )
+	if( zin || lzin )
+	    return;
+
+	if( codec == NET_CODEC_LZ4 )
+	{
+	    DEBUGPRINT( DEBUG_TRANS, "NetBuffer recv compressing (lz4)" );
+	    lzin = new NetLz4( 0 );
+	    return;
+	}
+
+	if( codec != NET_CODEC_ZLIB )
+	{
+	    e->Set( MsgSupp::InflateInit );
 	    return;
+	}
 
 	DEBUGPRINT( DEBUG_TRANS, "NetBuffer recv compressing"  );
 
@@ -180,6 +411,14 @@ NetBuffer::RecvCompression( Error *e )
 	    e->Set( MsgSupp::InflateInit );
 }
 
+int
+NetBuffer::RecvReady()
+{
+	// Data decoded but not yet received counts as ready.
+
+	return RecvBuffered() + ( lzin ? lzin->Pending() : 0 );
+}
+
 int
 NetBuffer::Receive( char *buffer, int length, Error *e )
 {
@@ -201,11 +440,33 @@ NetBuffer::Receive( char *buffer, int length, Error *re, Error *se )
 
 	while( len )
 	{
-	    int l = RecvReady();
+	    int l = RecvBuffered();
 
 	    // Fill user buffer if data ready
 
-	    if( zin && l )
+	    if( lzin && ( l || lzin->Pending() ) )
+	    {
+		// Decode the next frame, then copy into user buffer
+
+		if( !lzin->Pending() )
+		{
+		    int used = lzin->Unpack( recvPtr, l );
+
+		    if( used < 0 )
+		    {
+			re->Set( MsgSupp::Inflate );
+			return 0;
+		    }
+
+		    recvPtr += used;
+		}
+
+		l = lzin->Take( buf, len );
+		buf += l;
+		len -= l;
+		continue;
+	    }
+	    else if( zin && l )
 	    {
 		// Uncompress into user buffer
 
@@ -246,7 +507,7 @@ NetBuffer::Receive( char *buffer, int length, Error *re, Error *se )
 	    // ioPtrs to point outside our buffer space, we must be sure to
 	    // reset them.
 
-	    if( !zin && len >= recvBuf.Length() )
+	    if( !zin && !lzin && len >= recvBuf.Length() )
 	    {
 		// Must set (and then reset) for special purpose
 		// Limit it to recvBuf chunks.
@@ -274,7 +535,7 @@ NetBuffer::Receive( char *buffer, int length, Error *re, Error *se )
 	    // If compressing, we'll need to flush that separately.
 	    // If that produces readable data, don't need another read.
 
-	    if( zout )
+	    if( zout || lzout )
 	    {
 		Flush( re, se );
 		if( RecvReady() )
@@ -330,7 +591,7 @@ NetBuffer::Send( const char *buffer, int length, Error *re, Error *se )
 	    // If we can send without buffering, do so. Since we set the ioPtrs
 	    // to point outside our buffer space, we must be sure to reset them.
 
-	    if( !SendReady() && length >= sendLimit && !zout )
+	    if( !SendReady() && length >= sendLimit && !zout && !lzout )
 	    {
 		ioPtrs.sendPtr = (char *)buffer;
 		ioPtrs.sendEnd = (char *)buffer + length;
@@ -369,7 +630,21 @@ NetBuffer::Send( const char *buffer, int length, Error *re, Error *se )
 
 	    PackSend();
 
-	    if( zout )
+	    if( lzout )
+	    {
+		// Move a packed frame into SendRoom(), else stage more.
+
+		if( lzout->Pending() )
+		    ioPtrs.sendEnd += lzout->Take( ioPtrs.sendEnd, SendRoom() );
+		else
+		{
+		    int l = lzout->Stage( buffer, length );
+		    buffer += l;
+		    length -= l;
+		}
+		compressing = 1;
+	    }
+	    else if( zout )
 	    {
 		// Compress into SendRoom()
 
@@ -429,7 +704,17 @@ NetBuffer::Flush( Error *re, Error *se )
 
 	    PackSend();
 
-	    if( compressing && SendRoom() )
+	    if( compressing && SendRoom() && lzout )
+	    {
+		// Pack what's staged, move it into SendRoom()
+
+		if( !lzout->Pending() )
+		    lzout->Pack();
+
+		ioPtrs.sendEnd += lzout->Take( ioPtrs.sendEnd, SendRoom() );
+		compressing = lzout->Pending() || lzout->Staged();
+	    }
+	    else if( compressing && SendRoom() )
 	    {
 		// Flush compress into SendRoom()
 
@@ -18,7 +18,9 @@
  *	directly pass the caller's data to the transport.
  *
  *	NetBuffer also provides for compressing the link, one half at
- *	a time.
+ *	a time, with zlib or with LZ4 (NET_CODEC_LZ4): much faster, for
+ *	a little less compression.  The two ends must agree on the codec;
+ *	Rpc::StartCompression() negotiates it.
  *
  *	NB: once compression is turned on, it is on for the rest of the
  *	life of the NetBuffer.  Thus the caller should recreate the 
@@ -28,8 +30,8 @@
  *
  *	NetBuffer::NetBuffer( NetTransport *t ) - take ownership of t
  *	NetBuffer::SetBufferSizes() - up read/write buffer sizes to himark
- *	NetBuffer::SendCompression() - zlib the send pipe
- *	NetBuffer::RecvCompression() - zlib the recv pipe
+ *	NetBuffer::SendCompression() - zlib (or LZ4) the send pipe
+ *	NetBuffer::RecvCompression() - zlib (or LZ4) the recv pipe
  *	NetBuffer::Send() - send block data
  *	NetBuffer::Receive() - receive block data
  *	NetBuffer::Fill() - receive data to buffers
@@ -75,6 +77,15 @@
 
 typedef struct z_stream_s z_stream;
 class NetSslCredentials;
+class NetLz4;
+
+// Link compression codecs
+
+enum NetCodec {
+	NET_CODEC_ZLIB = 0,
+	NET_CODEC_LZ4 = 1,
+	NET_CODEC_MAX = 1
+} ;
 
 class NetBuffer : public NetTransport {
 
@@ -144,10 +155,10 @@ class NetBuffer : public NetTransport {
 	void		SetBufferSizes( int recvSize, int sendSize );
 	void		ResizeBuffer();
 
-	void		SendCompression( Error *e );
-	void		RecvCompression( Error *e );
+	void		SendCompression( Error *e, int codec = NET_CODEC_ZLIB );
+	void		RecvCompression( Error *e, int codec = NET_CODEC_ZLIB );
 
-	int RecvReady()	{ return ioPtrs.recvPtr - recvPtr; }
+	int RecvReady();
 	int DuplexReady() { return RecvReady() || transport->DuplexReady(); }
 	int GetFd() { return transport ? transport->GetFd() : -1; }
 	
@@ -157,6 +168,7 @@ class NetBuffer : public NetTransport {
     private:
 
 
+	int RecvBuffered() { return ioPtrs.recvPtr - recvPtr; }
 	int RecvDone()	{ return recvPtr - recvBuf.Text(); }
 	int RecvRoom() 	{ return ioPtrs.recvEnd - ioPtrs.recvPtr; }
 	int SendDone()	{ return ioPtrs.sendPtr - sendBuf.Text(); }
@@ -180,7 +192,7 @@ class NetBuffer : public NetTransport {
 	{
 	    if( RecvDone() )
 	    {
-		int l = RecvReady();
+		int l = RecvBuffered();
 		if( l == 0 )
 		{
 		    recvPtr = ioPtrs.recvPtr = recvBuf.Text();
@@ -222,5 +234,7 @@ class NetBuffer : public NetTransport {
 	int		compressing;
 	z_stream	*zin;
 	z_stream	*zout;
+	NetLz4		*lzin;
+	NetLz4		*lzout;
 
 } ;
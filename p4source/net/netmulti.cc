@@ -14,6 +14,280 @@
 # include <netbuffer.h>
 # include <bitarray.h>
 
+# ifdef NETMULTI_POLL
+
+# include <poll.h>
+# ifdef NETMULTI_EPOLL
+# include <sys/epoll.h>
+# endif
+
+/*
+ * NetMultiFd - a transport's descriptor and its state in the NetMulti
+ */
+
+struct NetMultiFd {
+	int		fd;
+	NetTransport	*t;
+	int		want;		// added since the last Clear()
+	int		ready;		// readable after the last Select()
+} ;
+
+NetMulti::NetMulti()
+{
+	fds = 0;
+	nfds = maxfds = 0;
+	slots = 0;
+	nslots = 0;
+	pfds = 0;
+# ifdef NETMULTI_EPOLL
+	epfd = epoll_create1( EPOLL_CLOEXEC );
+	events = 0;
+# endif
+}
+
+NetMulti::~NetMulti()
+{
+# ifdef NETMULTI_EPOLL
+	if( epfd >= 0 )
+	    close( epfd );
+	delete []static_cast<struct epoll_event *>( events );
+# endif
+	delete []static_cast<struct pollfd *>( pfds );
+	delete []slots;
+	delete []fds;
+}
+
+void
+NetMulti::Clear()
+{
+	// Entries stay until a Select() finds them unwanted, so that
+	// transports added again stay registered with epoll.
+
+	for( int i = 0; i < nfds; i++ )
+	    fds[i].want = fds[i].ready = 0;
+}
+
+void
+NetMulti::Grow( int fd )
+{
+	if( fd >= nslots )
+	{
+	    int n = nslots ? nslots * 2 : 64;
+	    if( n <= fd )
+		n = fd + 1;
+
+	    int *s = new int[ n ];
+	    for( int i = 0; i < n; i++ )
+		s[i] = i < nslots ? slots[i] : -1;
+
+	    delete []slots;
+	    slots = s;
+	    nslots = n;
+	}
+
+	if( nfds == maxfds )
+	{
+	    int n = maxfds ? maxfds * 2 : 16;
+
+	    NetMultiFd *f = new NetMultiFd[ n ];
+	    for( int i = 0; i < nfds; i++ )
+		f[i] = fds[i];
+
+	    delete []fds;
+	    delete []static_cast<struct pollfd *>( pfds );
+	    fds = f;
+	    pfds = new struct pollfd[ n ];
+# ifdef NETMULTI_EPOLL
+	    delete []static_cast<struct epoll_event *>( events );
+	    events = new struct epoll_event[ n ];
+# endif
+	    maxfds = n;
+	}
+}
+
+void
+NetMulti::Drop( int i )
+{
+# ifdef NETMULTI_EPOLL
+	// Fails harmlessly if the descriptor has been closed.
+
+	if( epfd >= 0 )
+	{
+	    struct epoll_event ev;
+	    memset( &ev, 0, sizeof( ev ) );
+	    epoll_ctl( epfd, EPOLL_CTL_DEL, fds[i].fd, &ev );
+	}
+# endif
+
+	slots[ fds[i].fd ] = -1;
+
+	if( i != --nfds )
+	{
+	    fds[i] = fds[ nfds ];
+	    slots[ fds[i].fd ] = i;
+	}
+}
+
+void
+NetMulti::Select( int block, Error *e )
+{
+	// Forget transports not added since the last Clear().
+
+	for( int i = 0; i < nfds; )
+	{
+	    if( fds[i].want )
+		++i;
+	    else
+		Drop( i );
+	}
+
+	if( !nfds )
+	    return;
+
+	int n;
+
+# ifdef NETMULTI_EPOLL
+	if( epfd >= 0 )
+	{
+	    struct epoll_event *ev = static_cast<struct epoll_event *>( events );
+
+	    while( ( n = epoll_wait( epfd, ev, nfds, block ? -1 : 0 ) ) < 0 &&
+		   errno == EINTR )
+		;
+
+	    if( n < 0 )
+	    {
+		e->Sys( "epoll_wait", "socket" );
+		return;
+	    }
+
+	    // EPOLLHUP and EPOLLERR count as readable: Fill() finds out.
+
+	    for( int i = 0; i < n; i++ )
+	    {
+		int fd = ev[i].data.fd;
+
+		if( fd < nslots && slots[ fd ] >= 0 )
+		    fds[ slots[ fd ] ].ready = 1;
+	    }
+
+	    return;
+	}
+# endif
+
+	struct pollfd *p = static_cast<struct pollfd *>( pfds );
+
+	for( int i = 0; i < nfds; i++ )
+	{
+	    p[i].fd = fds[i].fd;
+	    p[i].events = POLLIN;
+	    p[i].revents = 0;
+	}
+
+	while( ( n = poll( p, nfds, block ? -1 : 0 ) ) < 0 && errno == EINTR )
+	    ;
+
+	if( n < 0 )
+	{
+	    e->Sys( "poll", "socket" );
+	    return;
+	}
+
+	for( int i = 0; i < nfds; i++ )
+	    if( p[i].revents & ( POLLIN | POLLHUP | POLLERR | POLLNVAL ) )
+		fds[i].ready = 1;
+}
+
+void
+NetMulti::AddTransport( NetTransport *r, Error *e )
+{
+	int fd = r->GetFd();
+
+	if( fd < 0 )
+	    return;
+
+	Grow( fd );
+
+	int i = slots[ fd ];
+	int ok = 1;
+
+	if( i < 0 )
+	{
+	    i = slots[ fd ] = nfds++;
+	    fds[i].fd = fd;
+	    fds[i].t = r;
+	    ok = Register( i, e );
+	}
+	else if( fds[i].t != r )
+	{
+	    // Another transport has this descriptor: the old one was
+	    // closed without RemoveTransport(), so register anew.
+
+	    fds[i].t = r;
+	    ok = Register( i, e );
+	}
+
+	if( !ok )
+	{
+	    Drop( i );
+	    return;
+	}
+
+	fds[i].want = 1;
+	fds[i].ready = 0;
+}
+
+void
+NetMulti::RemoveTransport( NetTransport *r )
+{
+	int fd = r->GetFd();
+
+	if( fd < 0 || fd >= nslots || slots[ fd ] < 0 )
+	    return;
+
+	if( fds[ slots[ fd ] ].t == r )
+	    Drop( slots[ fd ] );
+}
+
+int
+NetMulti::Register( int i, Error *e )
+{
+# ifdef NETMULTI_EPOLL
+	if( epfd < 0 )
+	    return 1;
+
+	// It may still be registered, if the descriptor was closed while
+	// another one still referred to the same socket.
+
+	struct epoll_event ev;
+	memset( &ev, 0, sizeof( ev ) );
+	ev.events = EPOLLIN;
+	ev.data.fd = fds[i].fd;
+
+	if( epoll_ctl( epfd, EPOLL_CTL_ADD, fds[i].fd, &ev ) < 0 &&
+	    ( errno != EEXIST ||
+	      epoll_ctl( epfd, EPOLL_CTL_MOD, fds[i].fd, &ev ) < 0 ) )
+	{
+	    e->Sys( "epoll_ctl", "socket" );
+	    return 0;
+	}
+# endif
+	return 1;
+}
+
+int
+NetMulti::Readable( NetTransport *r, Error *e )
+{
+	int fd = r->GetFd();
+
+	if( fd < 0 || fd >= nslots || slots[ fd ] < 0 )
+	    return 0;
+
+	return fds[ slots[ fd ] ].ready;
+}
+
+# else
+
 NetMulti::NetMulti()
 {
 	fds = NULL;
@@ -29,12 +303,8 @@ void
 NetMulti::Clear()
 {
 	delete fds;
-# ifdef USE_SELECT_BITARRAY
-	fds = new BitArray( 1024 );
-# else
 	fds = new fd_set;
 	FD_ZERO( fds );
-# endif
 	maxfd = -1;
 }
 
@@ -46,13 +316,9 @@ NetMulti::Select( int block, Error *e )
 
 	if( maxfd < 0 )
 	    return;
-# ifdef USE_SELECT_BITARRAY
-	select( maxfd+1, (fd_set *)fds->fdset(), NULL, NULL,
-			block ? NULL : &tv );
-# else
+
 	select( maxfd+1, fds, NULL, NULL,
 			block ? NULL : &tv );
-# endif
 
 	// do something about errors XXX
 }
@@ -64,16 +330,17 @@ NetMulti::AddTransport( NetTransport *r, Error *e )
 
 	if( fd >= 0 )
 	{
-# ifdef USE_SELECT_BITARRAY
-	    fds->tas( fd );
-# else
 	    FD_SET( fd, fds );
-# endif
 	    if( fd > maxfd )
 		maxfd = fd;
 	}
 }
 
+void
+NetMulti::RemoveTransport( NetTransport * )
+{
+}
+
 int
 NetMulti::Readable( NetTransport *r, Error *e )
 {
@@ -81,9 +348,8 @@ NetMulti::Readable( NetTransport *r, Error *e )
 
 	if( fd < 0 )
 	    return 0;
-# ifdef USE_SELECT_BITARRAY
-	return (*fds)[ fd ];
-# else
+
 	return FD_ISSET( fd, fds );
-# endif
 }
+
+# endif
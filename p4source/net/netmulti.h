@@ -1,4 +1,46 @@
-class BitArray;
+/*
+ * NetMulti -- wait for any of several transports to become readable
+ *
+ * Public methods:
+ *
+ *	NetMulti::Clear() - forget the transports added for the last Select()
+ *	NetMulti::AddTransport() - add a transport to wait on
+ *	NetMulti::RemoveTransport() - forget a transport before it's closed
+ *	NetMulti::Select() - wait (or poll, if !block) for readable transports
+ *	NetMulti::Readable() - after Select(), is this transport readable?
+ *
+ * Notes:
+ *
+ *	A NetMulti may be reused: Clear(), AddTransport() each transport,
+ *	Select(), then Readable().  The cost of a Select() is in the number
+ *	of transports added, not in the value of their descriptors, and
+ *	there is no FD_SETSIZE limit.
+ *
+ *	On Linux the descriptors stay registered with an epoll instance
+ *	between Select()s: AddTransport() registers only a transport it
+ *	hasn't seen, and a Select() is one epoll_wait().  A transport not
+ *	added again after a Clear() is dropped by the next Select().
+ *	Other UNIX platforms, and Linux if the epoll instance can't be
+ *	created, use poll(); NT still uses select().
+ *
+ *	Closing a descriptor drops its epoll registration, and a new
+ *	transport (even at the same address) may get the same number, so
+ *	call RemoveTransport() before closing a transport that is to be
+ *	added again later.
+ *
+ *	epoll is level-triggered: NetTransport::Fill() reads what fits in
+ *	the buffer rather than draining the socket, so an edge-triggered
+ *	wait could miss data already queued.
+ */
+
+# if defined( OS_LINUX )
+# define NETMULTI_EPOLL
+# endif
+# if !defined( OS_NT )
+# define NETMULTI_POLL
+# endif
+
+struct NetMultiFd;
 
 class NetMulti {
     public:
@@ -14,14 +56,33 @@ class NetMulti {
 	/* Add a transport for read i/o */
 	void AddTransport( NetTransport *, Error *e );
 
+	/* Remove a transport, before it is closed */
+	void RemoveTransport( NetTransport * );
+
 	/* after a Select method, this call tells if a transport is readable */
 	int Readable( NetTransport *, Error *e );
 
     private:
-# ifdef USE_SELECT_BITARRAY
-	BitArray *fds;
+# ifdef NETMULTI_POLL
+	void	Grow( int fd );
+	void	Drop( int i );
+	int	Register( int i, Error *e );
+
+	NetMultiFd *fds;	// transports, in the order added
+	int	nfds;
+	int	maxfds;
+
+	int	*slots;		// fd -> index into fds, or -1
+	int	nslots;
+
+	void	*pfds;		// struct pollfd[ maxfds ]
+
+# ifdef NETMULTI_EPOLL
+	int	epfd;		// -1 to use poll()
+	void	*events;	// struct epoll_event[ maxfds ]
+# endif
 # else
 	fd_set	*fds;
-# endif
 	int	maxfd;
+# endif
 };
@@ -27,6 +27,10 @@
  *
  *	    Returns 1 if data is available to read, 0 if not (EOF).
  *	    Call Select() first.
+ *
+ * Where poll() is available it is used instead of select(): it waits
+ * on the one descriptor without building (and the kernel scanning)
+ * a bit array as large as the descriptor's value.
  */
 
 
@@ -38,6 +42,10 @@
 
 # if defined( OS_HPUX11 ) || defined( OS_NT )
 # define USE_SELECT_FDSET
+# elif defined( OS_LINUX ) || defined( OS_DARWIN ) || \
+	defined( OS_MACOSX ) || defined( OS_FREEBSD )
+# define USE_SELECT_POLL
+# include <poll.h>
 # else
 # define USE_SELECT_BITARRAY
 # endif
@@ -114,8 +122,58 @@ class NetTcpSelector
 
 # endif
 
+# ifdef USE_SELECT_POLL
+
+	NetTcpSelector( int t ) { fd = t; }
+
+# endif
+
 # ifdef USE_SELECTOR
 
+# ifdef USE_SELECT_POLL
+
+	/* Select() with poll(): errors and hangups wake either side */
+
+	int Select( int &read, int &write, int msec )
+	{
+	    struct pollfd p;
+
+	    p.fd = fd;
+	    p.events = ( read ? POLLIN : 0 ) | ( write ? POLLOUT : 0 );
+
+	    for( ;; )
+	    {
+		p.revents = 0;
+
+		switch( poll( &p, 1, msec >= 0 ? msec : -1 ) )
+		{
+		case -1:
+		    if( errno == EINTR )
+			continue;
+		    return -1;
+
+		case 0:
+		    read = write = 0;
+		    return 0;
+
+		default:
+		    if( p.revents & POLLNVAL )
+		    {
+			errno = EBADF;
+			return -1;
+		    }
+
+		    read = read &&
+			( p.revents & ( POLLIN | POLLERR | POLLHUP ) );
+		    write = write &&
+			( p.revents & ( POLLOUT | POLLERR | POLLHUP ) );
+		    return 1;
+		}
+	    }
+	}
+
+# else
+
 	/* Select() that works with BitArray or fd_set */
 
 	int Select( int &read, int &write, int msec )
@@ -158,6 +216,8 @@ class NetTcpSelector
 	    }
 	}
 
+# endif
+
 # if defined(OS_NT) || defined(OS_SOLARIS)
 
 	int Peek()
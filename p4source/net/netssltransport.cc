@@ -96,6 +96,10 @@ extern "C"
 # include "netssltransport.h"
 # include "netsslmacros.h"
 
+# ifdef HAS_CPP11
+# include <mutex>
+# endif
+
 # if OPENSSL_VERSION_NUMBER < 0x10100000L
 extern "C" {
 
@@ -468,6 +472,13 @@ MillisecondDifference(const DateTimeHighPrecision &lop,
 ////////////////////////////////////////////////////////////////////////////
 SSL_CTX *NetSslTransport::sServerCtx = NULL;
 SSL_CTX *NetSslTransport::sClientCtx = NULL;
+SSL_SESSION *NetSslTransport::sClientSession = NULL;
+StrBuf NetSslTransport::sClientSessionPeer;
+
+# if defined( HAS_CPP11 ) && OPENSSL_VERSION_NUMBER >= 0x10101000L
+# define SSL_SESSION_REUSE
+static std::mutex sClientSessionMutex;
+# endif
 
 
 /**
@@ -1118,6 +1129,9 @@ NetSslTransport::DoHandshake( Error *e )
 	SSL_set_bio( ssl, bio, bio );
 	SSLLOGFUNCTION( "NetSslTransport::DoHandshake SSL_set_bio" );
 
+	if( !isAccepted )
+	    ResumeSession();
+
 	/*
 	 * Blocking mode disables our DoS prevention
 	 * but might be more reliable under heavy connection load.
@@ -1182,6 +1196,8 @@ NetSslTransport::DoHandshake( Error *e )
 	    }
 	    X509_free( serverCert );
 	    SSLLOGFUNCTION( "X509_free" );
+
+	    SaveSession();
 	}
 
 	return;
@@ -1220,6 +1236,73 @@ failNoRead:
 	}
 }
 
+/**
+ * NetSslTransport::ResumeSession
+ *
+ * @brief offer the server the last session saved for it, so that a
+ * client making several connections to one server (parallel sync and
+ * submit) can skip the full handshake.  Only with ssl.client.session.reuse.
+ * The server certificate is checked as usual: it is kept in the session.
+ */
+void
+NetSslTransport::ResumeSession()
+{
+# ifdef SSL_SESSION_REUSE
+	if( !p4tunable.Get( P4TUNE_SSL_CLIENT_SESSION_REUSE ) )
+	    return;
+
+	std::lock_guard< std::mutex > lock( sClientSessionMutex );
+
+	if( !sClientSession ||
+	    sClientSessionPeer != GetPortParser().HostPort() )
+	    return;
+
+	ERR_clear_error();
+	SSL_set_session( ssl, sClientSession );
+	SSLLOGFUNCTION( "NetSslTransport::ResumeSession SSL_set_session" );
+# endif
+}
+
+/**
+ * NetSslTransport::SaveSession
+ *
+ * @brief after a full handshake, keep the session for ResumeSession(),
+ * if the server allows it to be resumed.  One session is kept: the
+ * connections to be sped up are all to the same server.
+ */
+void
+NetSslTransport::SaveSession()
+{
+# ifdef SSL_SESSION_REUSE
+	if( !p4tunable.Get( P4TUNE_SSL_CLIENT_SESSION_REUSE ) ||
+	    SSL_session_reused( ssl ) )
+	    return;
+
+	SSL_SESSION *session = SSL_get1_session( ssl );
+
+	if( !session )
+	    return;
+
+	if( !SSL_SESSION_is_resumable( session ) )
+	{
+	    SSL_SESSION_free( session );
+	    return;
+	}
+
+	std::lock_guard< std::mutex > lock( sClientSessionMutex );
+
+	if( sClientSession )
+	    SSL_SESSION_free( sClientSession );
+
+	sClientSession = session;
+	sClientSessionPeer.Set( GetPortParser().HostPort() );
+
+	if( SSLDEBUG_CONNECT )
+	    p4debug.printf( "NetSslTransport::SaveSession for %s\n",
+	                    sClientSessionPeer.Text() );
+# endif
+}
+
 /**
  * NetSslTransport::SslHandshake
  *
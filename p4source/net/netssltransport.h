@@ -108,10 +108,14 @@ class NetSslTransport : public NetTcpTransport
 
 	static bool     VerifyKeyFile( const char *path );
 	bool            SslHandshake( Error *e );
+	void            ResumeSession();
+	void            SaveSession();
 
 	static unsigned long  sCompileVersion;
 	static SSL_CTX *sServerCtx;
 	static SSL_CTX *sClientCtx;
+	static SSL_SESSION *sClientSession;	// see SaveSession()
+	static StrBuf   sClientSessionPeer;
 	BIO *           bio;
 	SSL *           ssl;
 	StrBuf          cipherSuite;
@@ -315,6 +315,7 @@ Rpc::Rpc( RpcService *s )
 
 	sendBuffer = new RpcSendBuffer;
 	recvBuffer = new RpcRecvBuffer;
+	spareRecvBuffer = 0;
 	protoDynamic = new StrBufDict;
 
 	duplexFsend = 0;
@@ -329,6 +330,7 @@ Rpc::Rpc( RpcService *s )
 
 	protocolSent = 0;
 	protocolServer = 0;
+	protocolCodec = 0;
 
 	rpc_hi_mark_rev = 
 	rpc_hi_mark_fwd = p4tunable.Get( P4TUNE_RPC_HIMARK );
@@ -353,6 +355,7 @@ Rpc::~Rpc( void )
 
 	delete sendBuffer;
 	delete recvBuffer;
+	delete spareRecvBuffer;
 	delete protoDynamic;
 	delete timer;
 }
@@ -1067,7 +1070,7 @@ Rpc::Dispatch( DispatchFlag flag, RpcDispatcher *dispatcher )
 		     se.Test() )
 	    {
 		if( !recvBuffer )
-		    recvBuffer = new RpcRecvBuffer;
+		    recvBuffer = NewRecvBuffer();
 
 		DispatchOne( dispatcher, flag == DfContain );
 
@@ -1080,7 +1083,7 @@ Rpc::Dispatch( DispatchFlag flag, RpcDispatcher *dispatcher )
 
 	// Pop recvBuffer.
 
-	delete recvBuffer;
+	FreeRecvBuffer( recvBuffer );
 
 # ifdef HAS_CPP11
 	recvBuffer = savRecvBuffer.release();
@@ -1098,6 +1101,48 @@ Rpc::Dispatch( DispatchFlag flag, RpcDispatcher *dispatcher )
 	    endDispatch = 0;
 }
 
+/*
+ * NewRecvBuffer()/FreeRecvBuffer() - receive buffers for Dispatch()
+ *
+ * Each nested Dispatch() needs its own receive buffer, and file
+ * transfers nest a Dispatch() per InvokeDuplex().  Keep the last one
+ * freed, so its ioBuffer (grown to fit the messages it has seen) is
+ * reused and large messages are received without reallocating.  One
+ * grown past net.rcvbufsize is let go rather than held for the life
+ * of the Rpc on account of a single huge message.
+ */
+
+RpcRecvBuffer *
+Rpc::NewRecvBuffer()
+{
+	RpcRecvBuffer *b = spareRecvBuffer;
+
+	if( !b )
+	    return new RpcRecvBuffer;
+
+	spareRecvBuffer = 0;
+	return b;
+}
+
+void
+Rpc::FreeRecvBuffer( RpcRecvBuffer *b )
+{
+	if( !b )
+	    return;
+
+	if( b->GetBufferAlloc() > p4tunable.Get( P4TUNE_NET_RCVBUFSIZE ) ||
+	    ( spareRecvBuffer && 
+	      spareRecvBuffer->GetBufferAlloc() >= b->GetBufferAlloc() ) )
+	{
+	    delete b;
+	    return;
+	}
+
+	delete spareRecvBuffer;
+	b->GetBuffer();		// drop vars of the last message
+	spareRecvBuffer = b;
+}
+
 NO_SANITIZE_UNDEFINED
 void
 Rpc::RunCallback( const RpcDispatch *disp, Error &ue )
@@ -1256,6 +1301,12 @@ Rpc::DispatchReady()
 	return !endDispatch && transport && transport->DuplexReady();
 }
 
+int
+Rpc::IsAlive()
+{
+	return !Dropped() && transport && transport->IsAlive();
+}
+
 int
 Rpc::SuspendDispatch( int v )
 {
@@ -1293,6 +1344,12 @@ Rpc::PriorityDispatch( int v )
  *     and then turns on both send and receieve compression.
  *
  * 3.  When this end receives "compress2", it turns on receive compression.
+ *
+ * The link is zlib compressed unless "compress1" names another codec in
+ * "linkCodec".  This end names one only if net.compression.codec allows
+ * it and the other end advertised it with a "linkCodec" protocol level
+ * (protocolCodec); the other end echoes it in "compress2".  Peers that
+ * don't know of codecs never advertise, and so get zlib.
  */
 
 void
@@ -1301,20 +1358,36 @@ Rpc::StartCompression( Error *e )
 	// send the "compress1" flag, then compress the send link.
 	// When we get "compress2", we'll compress the recv link.
 
+	int codec = p4tunable.Get( P4TUNE_NET_COMPRESSION_CODEC );
+
+	if( codec > protocolCodec )
+	    codec = protocolCodec;
+
+	if( codec )
+	    SetVar( P4Tag::v_linkCodec, codec );
+
 	Invoke( P4Tag::p_compress1 );
-	transport->SendCompression( e );
+	transport->SendCompression( e, codec );
 }
 
 void
-Rpc::GotSendCompressed(  Error *e )
+Rpc::GotSendCompressed(  Error *e, int codec )
 {
-	transport->SendCompression( e );
+	transport->SendCompression( e, codec );
 }
 
 void
-Rpc::GotRecvCompressed(  Error *e )
+Rpc::GotRecvCompressed(  Error *e, int codec )
+{
+	transport->RecvCompression( e, codec );
+}
+
+int
+Rpc::GetLinkCodec()
 {
-	transport->RecvCompression( e );
+	StrPtr *s = GetVar( P4Tag::v_linkCodec );
+
+	return s ? s->Atoi() : NET_CODEC_ZLIB;
 }
 
 void
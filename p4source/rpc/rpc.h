@@ -50,6 +50,8 @@
  *	Rpc::IoError() - pointer to error struct describing dropped connection
  *	Rpc::DispatchReady() - connection is servicable and has a message
  *			immediately avilable for Dispatching.
+ *	Rpc::IsAlive() - connection is servicable and not closed by the
+ *			other end (for idle connections kept for reuse).
  *	Rpc::SuspendDispatch() - Block or unblock dispatch of this Rpc
  *		by the RpcMulti class
  *
@@ -61,6 +63,7 @@
  *	Rpc::GotReleased() - note receipt of "release" sent by Release()
  * 	Rpc::GotRecvCompress() -- turn on recv half compression
  *	Rpc::GotSendCompress() -- turn on send half compression
+ *	Rpc::GetLinkCodec() -- codec named in compress1/compress2
  *
  * Public structures:
  *
@@ -302,6 +305,7 @@ class Rpc : public StrDict {
 
 	int		Active();
 	int		DispatchReady();
+	int		IsAlive();
 	int		SuspendDispatch( int );
 	int		PriorityDispatch( int );
 
@@ -310,6 +314,7 @@ class Rpc : public StrDict {
 	void		SetHiMark( int sndbuf, int rcvbuf );
 
 	int		protocolServer;		// 'server'/'server2' protocol
+	int		protocolCodec;		// 'linkCodec' protocol
 
     public:
 
@@ -317,8 +322,9 @@ class Rpc : public StrDict {
 
 	void		GotFlushed();
 	void		GotReleased() { endDispatch = 1; }
-	void		GotSendCompressed( Error *e );
-	void		GotRecvCompressed( Error *e );
+	void		GotSendCompressed( Error *e, int codec = 0 );
+	void		GotRecvCompressed( Error *e, int codec = 0 );
+	int		GetLinkCodec();
 	int		InvokeOne( const char *opName );
 
 	void		FlushTransport();
@@ -372,12 +378,16 @@ class Rpc : public StrDict {
 
 	void		RunCallback( const RpcDispatch *disp, Error &ue );
 
+	RpcRecvBuffer	*NewRecvBuffer();
+	void		FreeRecvBuffer( RpcRecvBuffer *b );
+
 	RpcService	*service;
 	RpcTransport	*transport;		// send/receive transport
 	RpcForward	*forward;		// for proxying
 
 	RpcSendBuffer	*sendBuffer;		// var/values to send
 	RpcRecvBuffer	*recvBuffer;		// var/values received 
+	RpcRecvBuffer	*spareRecvBuffer;	// kept for the next Dispatch()
 	StrDict		*protoDynamic;
 
 	int		duplexFsend;		// bytes InvokeDuplex sent
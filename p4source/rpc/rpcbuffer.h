@@ -23,6 +23,13 @@
  *
  *	RpcBuffer::CopyVars() - copy all variables from another RpcBuffer
  *
+ * Parse() does not copy: the values returned by GetVar() point into
+ * the receive buffer and are good until the next GetBuffer()/Parse(),
+ * i.e. until the next message is dispatched.  Rpc recycles receive
+ * buffers across nested Dispatch() calls, so the buffer usually has
+ * room for a message already and RpcTransport::Receive() reads it
+ * straight in.
+ *
  * Private methods:
  *
  *	RpcBuffer::EndVar() - set actual length from MakeVar
@@ -66,6 +73,9 @@ class RpcRecvBuffer
 	int		GetBufferSize()
 			{ return ioBuffer.Length(); }
 
+	int		GetBufferAlloc()
+			{ return ioBuffer.BufSize(); }
+
 	void		CopyBuffer( const RpcRecvBuffer *fromBuffer )
 			{ ioBuffer.Set( fromBuffer->ioBuffer ); }
 
@@ -78,7 +88,7 @@ class RpcRecvBuffer
     friend class RpcSendBuffer;
 
 	StrBuf 		ioBuffer;	// data area
-	StrPtrDict	syms;		// for named symbols
+	StrPtrHashDict	syms;		// for named symbols
 	StrPtrArray	args;		// for unnamed symbols
 	bool		isAccepted;
 
@@ -17,28 +17,107 @@
 # include "rpcdispatch.h"
 # include "rpcdebug.h"
 
+# define CHARHASH( h, c ) ( 293 * (h) + (c) )
+
+struct RpcDispatchSlot {
+	unsigned int		hash;
+	const RpcDispatch	*disp;		// 0 if empty
+} ;
+
+static unsigned int
+RpcDispatchHash( const char *p )
+{
+	unsigned int h = 0;
+	while( *p )
+	    h = CHARHASH( h, (unsigned char)*p++ );
+	return h;
+}
+
 RpcDispatcher::RpcDispatcher( void )
 {
 	dispatches = new VarArray;
 	altDispatcher = 0;
 	altindex = -1;
+	index = 0;
+	indexMask = 0;
 }
 
 RpcDispatcher::~RpcDispatcher( void )
 {
 	delete altDispatcher;
 	delete dispatches;
+	delete []index;
 }
 
 void
 RpcDispatcher::Add( const RpcDispatch *dispatch )
 {
 	dispatches->Put( (void *)dispatch );
+	BuildIndex();
+}
+
+void
+RpcDispatcher::BuildIndex()
+{
+	int n = 0;
+
+	for( int i = 0; i < dispatches->Count(); i++ )
+	    for( const RpcDispatch *d = (RpcDispatch *)dispatches->Get(i);
+	         d->opName; d++ )
+		n++;
+
+	// At most half full.
+
+	int size = 16;
+	while( size < n * 2 )
+	    size *= 2;
+
+	delete []index;
+	index = new RpcDispatchSlot[ size ];
+	indexMask = size - 1;
+
+	for( int i = 0; i < size; i++ )
+	    index[i].disp = 0;
+
+	// Same precedence as the linear search: last table first,
+	// first entry of a name within a table.
+
+	for( int i = dispatches->Count(); i--; )
+	{
+	    for( const RpcDispatch *d = (RpcDispatch *)dispatches->Get(i);
+	         d->opName; d++ )
+	    {
+		unsigned int h = RpcDispatchHash( d->opName );
+		int j = h & indexMask;
+
+		while( index[j].disp && ( index[j].hash != h ||
+		       strcmp( index[j].disp->opName, d->opName ) ) )
+		    j = ( j + 1 ) & indexMask;
+
+		if( index[j].disp )
+		    continue;
+
+		index[j].hash = h;
+		index[j].disp = d;
+	    }
+	}
 }
 
 const RpcDispatch *
 RpcDispatcher::Find( const char *func )
 {
+	if( index && !altDispatcher )
+	{
+	    unsigned int h = RpcDispatchHash( func );
+
+	    for( int j = h & indexMask; index[j].disp;
+	         j = ( j + 1 ) & indexMask )
+		if( index[j].hash == h && !strcmp( func, index[j].disp->opName ) )
+		    return index[j].disp;
+
+	    return 0;
+	}
+
 	for( int i = dispatches->Count(); i--; )
 	{
 	    // If we have dispatch items pushed on
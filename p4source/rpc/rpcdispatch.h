@@ -7,6 +7,16 @@
 class VarArray ;
 class AltDispatcher;
 class Tnode;
+struct RpcDispatchSlot;
+
+/*
+ * RpcDispatcher - the function tables of an RpcService
+ *
+ * Tables added later are searched first; within a table the first
+ * entry for a name wins.  Add() rebuilds a hash index over all the
+ * tables with that precedence, and Find() uses it for every message
+ * unless the AltDispatcher trie has been asked for.
+ */
 
 class RpcDispatcher {
     public:
@@ -21,10 +31,15 @@ class RpcDispatcher {
 
     private:
 
+	void		BuildIndex();
+
 	VarArray	*dispatches;
 	AltDispatcher	*altDispatcher;
 	int		altindex;
 
+	RpcDispatchSlot	*index;		// open addressing, by opName
+	int		indexMask;	// slot count - 1
+
 } ;
 
 // An alternative dispatcher build on the Trie
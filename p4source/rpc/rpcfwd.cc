@@ -194,17 +194,21 @@ RpcForward::ForwardExcept( Rpc *src, Rpc *dst, const StrPtr &except )
 void
 RpcForward::Compress1( Error *e )
 {
-	server->GotRecvCompressed( e );
+	int codec = server->GetLinkCodec();
+
+	server->GotRecvCompressed( e, codec );
 	Forward( server, client );
-	client->GotSendCompressed( e );
+	client->GotSendCompressed( e, codec );
 }
 
 void
 RpcForward::Compress2( Error *e )
 {
-	client->GotRecvCompressed( e );
+	int codec = client->GetLinkCodec();
+
+	client->GotRecvCompressed( e, codec );
 	Forward( client, server );
-	server->GotSendCompressed( e );
+	server->GotSendCompressed( e, codec );
 }
 
 void
@@ -256,7 +260,7 @@ RpcForward::Flush1( Error *e )
 	    KeepAlive *k = client->GetKeepAlive();
 
 	    RpcRecvBuffer *oldbuf = client->recvBuffer;
-	    client->recvBuffer = new RpcRecvBuffer;
+	    client->recvBuffer = client->NewRecvBuffer();
 
 	    while( duplexCount > himark2 )
 	    {
@@ -266,7 +270,7 @@ RpcForward::Flush1( Error *e )
 		client->DispatchOne( c2sDispatcher );
 	    }
 
-	    delete client->recvBuffer;
+	    client->FreeRecvBuffer( client->recvBuffer );
 	    client->recvBuffer = oldbuf;
 	}
 	else
@@ -38,10 +38,12 @@
 
 RpcMulti::RpcMulti()
 {
+	mux = new NetMulti;
 }
 
 RpcMulti::~RpcMulti()
 {
+	delete mux;
 }
 
 int
@@ -64,6 +66,9 @@ RpcMulti::Remove( Rpc *rpc )
 	{
 	    if( RpcArray.Get( i ) == (void *)rpc )
 	    {
+		if( rpc->transport )
+		    mux->RemoveTransport( rpc->transport );
+
 		RpcArray.Remove( i );
 		DispatcherArray.Remove( i );
 		return 1;
@@ -115,23 +120,23 @@ void
 RpcMulti::MultiRead( int blocking, Error *e )
 {
 	Rpc *wrpc;
-	NetMulti mux;
 
 	// build masks
+	mux->Clear();
 	for( int i = 0; ( wrpc = (Rpc *)RpcArray.Get( i ) ); ++i )
 	{
-	    mux.AddTransport( wrpc->transport, e );
+	    mux->AddTransport( wrpc->transport, e );
 	    if( e->Test() )
 		return;
 	    wrpc->FlushTransport();
 	}
 	// select
-	mux.Select( blocking, e );
+	mux->Select( blocking, e );
 	if( e->Test() )
 	    return;
 	for( int i = 0; ( wrpc = (Rpc *)RpcArray.Get( i ) ); ++i )
 	{
-	    if( mux.Readable( wrpc->transport, e ) )
+	    if( mux->Readable( wrpc->transport, e ) )
 		wrpc->transport->Fill( &wrpc->re, &wrpc->se );
 	}
 }
@@ -2,6 +2,8 @@
  * A class to allow multiple RPC polling and dispatching
  */
 
+class NetMulti;
+
 class RpcMulti
 {
     public:
@@ -10,7 +12,8 @@ class RpcMulti
 
 	// add an rpc object to the group
 	int Add( Rpc *, RpcDispatcher * );
-	// remove an rpc object from the group
+	// remove an rpc object from the group; do so before
+	// disconnecting it, if it may be added again
 	int Remove( Rpc * );
 
 	// test if any rpc object in the group is active
@@ -26,4 +29,5 @@ class RpcMulti
     private:
 	VarArray	RpcArray;
 	VarArray	DispatcherArray;
+	NetMulti	*mux;		// kept so epoll registrations persist
 };
@@ -35,15 +35,19 @@
 void
 RpcServerCompress1( Rpc *rs, Error *e )
 {
-	rs->GotRecvCompressed( e );
+	int codec = rs->GetLinkCodec();
+
+	rs->GotRecvCompressed( e, codec );
+	if( codec )
+	    rs->SetVar( P4Tag::v_linkCodec, codec );
 	rs->InvokeOne( P4Tag::p_compress2 );
-	rs->GotSendCompressed( e );
+	rs->GotSendCompressed( e, codec );
 }
 
 void
 RpcServerCompress2( Rpc *rs, Error *e )
 {
-	rs->GotRecvCompressed( e );
+	rs->GotRecvCompressed( e, rs->GetLinkCodec() );
 }
 
 void
@@ -79,6 +83,9 @@ RpcServerProtocol( Rpc *rs, Error *e )
 	if( ( s = rs->GetVar( P4Tag::v_server2 ) ) ||
 	    ( s = rs->GetVar( P4Tag::v_server ) ) )
 		rs->protocolServer = s->Atoi();
+
+	if( ( s = rs->GetVar( P4Tag::v_linkCodec ) ) )
+		rs->protocolCodec = s->Atoi();
 }
 
 void
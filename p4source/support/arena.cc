@@ -0,0 +1,201 @@
+/*
+ * Copyright 2024 Perforce Software.  All rights reserved.
+ *
+ * This file is part of Perforce - the FAST SCM System.
+ */
+
+/*
+ * arena.cc - bump allocation for short-lived objects
+ */
+
+# include <stdhdrs.h>
+
+# include "arena.h"
+
+# ifdef HAS_CPP11
+# include <atomic>
+# include <new>
+
+/*
+ * ArenaBlock - the head of a block of memory
+ * ArenaHeader - precedes each allocation; block is 0 if from the heap
+ *
+ * A block's refs count its live allocations, plus one while it is
+ * the arena's current block.  Whoever drops the last one frees it.
+ */
+
+struct ArenaBlock {
+	std::atomic< int >	refs;
+	char			*next;
+	char			*end;
+} ;
+
+union ArenaHeader {
+	ArenaBlock		*block;
+	double			align[2];
+} ;
+
+// Allocations are rounded up to keep the next one aligned.
+
+# define ARENA_ALIGN	sizeof( ArenaHeader )
+# define ARENA_ROUND( n ) ( ( (n) + ARENA_ALIGN - 1 ) & ~( ARENA_ALIGN - 1 ) )
+
+static thread_local Arena *arenaCurrent = 0;
+
+Arena::Arena( int blockSize )
+{
+	this->blockSize = blockSize < 4096 ? 4096 : blockSize;
+	block = 0;
+	allocs = 0;
+	blocks = 0;
+}
+
+Arena::~Arena()
+{
+	if( arenaCurrent == this )
+	    arenaCurrent = 0;
+
+	// Anything still live keeps its block.
+
+	if( block )
+	    Release( block );
+}
+
+Arena *
+Arena::Current()
+{
+	return arenaCurrent;
+}
+
+void
+Arena::SetCurrent( Arena *a )
+{
+	arenaCurrent = a;
+}
+
+void *
+Arena::Alloc( Arena *a, size_t n )
+{
+	size_t need = sizeof( ArenaHeader ) + ARENA_ROUND( n );
+	ArenaHeader *h;
+
+	if( !a || need > (size_t)a->blockSize / 4 )
+	{
+	    h = (ArenaHeader *)::operator new( need );
+	    h->block = 0;
+	    return h + 1;
+	}
+
+	ArenaBlock *b = a->block;
+
+	if( !b || b->next + need > b->end )
+	    b = a->NewBlock();
+
+	h = (ArenaHeader *)b->next;
+	h->block = b;
+	b->next += need;
+	b->refs.fetch_add( 1, std::memory_order_relaxed );
+	++a->allocs;
+
+	return h + 1;
+}
+
+void
+Arena::Free( void *p )
+{
+	if( !p )
+	    return;
+
+	ArenaHeader *h = (ArenaHeader *)p - 1;
+
+	if( h->block )
+	    Release( h->block );
+	else
+	    ::operator delete( h );
+}
+
+void
+Arena::Release( ArenaBlock *b )
+{
+	if( b->refs.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+	    ::operator delete( b );
+}
+
+ArenaBlock *
+Arena::NewBlock()
+{
+	// If nothing in the current block is live, just start it over;
+	// otherwise leave it to the last of its allocations to free.
+
+	if( block && block->refs.load( std::memory_order_acquire ) == 1 )
+	{
+	    block->next = (char *)block + ARENA_ROUND( sizeof( ArenaBlock ) );
+	    return block;
+	}
+
+	if( block )
+	    Release( block );
+
+	block = (ArenaBlock *)::operator new( blockSize );
+	new( &block->refs ) std::atomic< int >( 1 );
+	block->next = (char *)block + ARENA_ROUND( sizeof( ArenaBlock ) );
+	block->end = (char *)block + blockSize;
+	++blocks;
+
+	return block;
+}
+
+void
+Arena::Reset()
+{
+	// Only the arena itself holds the block: it's all free space.
+
+	if( block && block->refs.load( std::memory_order_acquire ) == 1 )
+	    block->next = (char *)block + ARENA_ROUND( sizeof( ArenaBlock ) );
+}
+
+# else
+
+// No threads: no arenas.
+
+Arena::Arena( int )
+{
+	block = 0;
+	blockSize = 0;
+	allocs = 0;
+	blocks = 0;
+}
+
+Arena::~Arena()
+{
+}
+
+Arena *
+Arena::Current()
+{
+	return 0;
+}
+
+void
+Arena::SetCurrent( Arena * )
+{
+}
+
+void *
+Arena::Alloc( Arena *, size_t n )
+{
+	return ::operator new( n );
+}
+
+void
+Arena::Free( void *p )
+{
+	::operator delete( p );
+}
+
+void
+Arena::Reset()
+{
+}
+
+# endif
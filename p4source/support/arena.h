@@ -0,0 +1,85 @@
+/*
+ * Copyright 2024 Perforce Software.  All rights reserved.
+ *
+ * This file is part of Perforce - the FAST SCM System.
+ */
+
+/*
+ * arena.h - bump allocation for short-lived objects
+ *
+ * Classes defined:
+ *
+ *	Arena - hands out memory in order from large blocks
+ *	ArenaScope - makes an Arena this thread's current one, for a while
+ *
+ * Public methods:
+ *
+ *	Arena::Alloc() - (static) allocate from an arena, or the heap if 0
+ *	Arena::Free() - (static) free what Alloc() returned
+ *	Arena::Reset() - start the arena over, if all it gave out is freed
+ *	Arena::Current() - (static) the thread's current arena, or 0
+ *
+ * Notes:
+ *
+ *	Classes opt in with their own operator new and delete, calling
+ *	Alloc( Arena::Current(), n ) and Free(): see FileSys, PathSys and
+ *	ClientFile.  Code that makes many of them for a short while, like
+ *	the client handling a command, puts an ArenaScope around it.
+ *
+ *	Each allocation is preceded by a pointer to its block, so Free()
+ *	needs no arena, and a block lives until the last allocation in
+ *	it is freed: an object may outlive its arena, keeping just its
+ *	block.  Space freed in a block is reused only once the whole
+ *	block is free.  Allocations bigger than a quarter of a block, or
+ *	made with no arena, come from the heap, with the same header.
+ *
+ *	Alloc() and Reset() are for the thread that owns the arena; Free()
+ *	can be called from any.  Without HAS_CPP11 everything comes from
+ *	the heap.
+ */
+
+struct ArenaBlock;
+
+class Arena {
+
+    public:
+			Arena( int blockSize );
+			~Arena();
+
+	static void *	Alloc( Arena *a, size_t n );
+	static void	Free( void *p );
+
+	void		Reset();
+
+	static Arena *	Current();
+	static void	SetCurrent( Arena *a );
+
+	// For -v debugging
+
+	int		GetAllocs() { return allocs; }
+	int		GetBlocks() { return blocks; }
+
+    private:
+
+	ArenaBlock *	NewBlock();
+	static void	Release( ArenaBlock *b );
+
+	ArenaBlock	*block;		// being allocated from
+	int		blockSize;
+
+	int		allocs;
+	int		blocks;		// blocks allocated
+} ;
+
+class ArenaScope {
+
+    public:
+			ArenaScope( Arena *a )
+			{ old = Arena::Current(); Arena::SetCurrent( a ); }
+
+			~ArenaScope()
+			{ Arena::SetCurrent( old ); }
+
+    private:
+	Arena		*old;
+} ;
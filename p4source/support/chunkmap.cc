@@ -12,6 +12,7 @@
 # include <strbuf.h>
 # include <filesys.h>
 # include <debug.h>
+# include <tunable.h>
 # include <strops.h>
 # include <json.hpp>
 # include <md5.h>
@@ -20,6 +21,8 @@
 # include <string>
 # include <cstdint>
 # include <inttypes.h>
+# include <thread>
+# include <vector>
 
 # include "blake3digester.h"
 # include "fastcdc.h"
@@ -306,6 +309,32 @@ ChunkMap::Create( FileSys* in, Error* e, MD5* md5 )
 	b3.Update( version_cast, sizeof( version ) );
 	((StrBuf*)mapBuf)->Append( version_cast, sizeof( version ) );
 
+	// Big files can be chunked on several threads.
+
+	const int threads = p4tunable.Get( P4TUNE_NET_DELTA_TRANSFER_THREADS );
+
+	if( threads > 1 && in->GetSize() >= (offL_t)( 2 * parallelSegment ) )
+	{
+	    numChunks = CreateParallel( in, e, md5, threads, b3 );
+	}
+	else
+	{
+	    numChunks = CreateSerial( in, e, md5, b3 );
+	}
+
+	StrBuf final_hash;
+	final_hash.BlockAlloc( BLAKE3_BUFFLEN );
+	b3.Final( (unsigned char*)final_hash.Text() );
+
+	((StrBuf*)mapBuf)->Append( &final_hash );
+
+	in->Seek( origPos, e );
+	Parse( "Create", "", e );
+}
+
+size_t
+ChunkMap::CreateSerial( FileSys* in, Error* e, MD5* md5, BLAKE3& b3 )
+{
 	// Fixed-size buffer to copy into while processing.  Limits the
 	// amount of memory copies into the final buffer. ???
 
@@ -394,16 +423,210 @@ ChunkMap::Create( FileSys* in, Error* e, MD5* md5 )
 	// Finish a partially-filled buffer.
 
 	chunker.Finish();
-	numChunks = chunker.nTotalChunks;
+	return chunker.nTotalChunks;
+}
 
-	StrBuf final_hash;
-	final_hash.BlockAlloc( BLAKE3_BUFFLEN );
-	b3.Final( (unsigned char*)final_hash.Text() );
+/*
+ * Parallel chunking
+ *
+ * A cut point depends only on the (up to cdc_max_size) bytes from the
+ * start of its chunk, so chunking can be resumed at any cut point.  The
+ * file is read in batches of up to 'threads' segments.  Each thread
+ * chunks and hashes one segment as if a chunk started at its first
+ * byte, running on past the segment's end to the first cut beyond it.
+ *
+ * The segments are then stitched together in order.  The first starts
+ * at a real cut point, so its chunks are taken as is.  Where the last
+ * of them ends inside the next segment, that segment's chunks are taken
+ * from the matching cut point on; until there is one, chunks are found
+ * and hashed serially.  In practice a segment falls into step with the
+ * real cut points within a chunk or two, so little work is redone.
+ * Bytes too few to chunk before the end of the file carry over into
+ * the next batch.  The map is the same as from the serial chunker.
+ */
 
-	((StrBuf*)mapBuf)->Append( &final_hash );
+const size_t ChunkMap::parallelSegment = 8 * 1024 * 1024;
 
-	in->Seek( origPos, e );
-	Parse( "Create", "", e );
+struct ChunkSegment
+{
+	size_t start;		// batch offset of first chunk
+	size_t end;		// chunk up to here (and past)
+	size_t stop;		// where chunking stopped
+	std::vector< uint32_t > sizes;
+	std::vector< uint8_t > digests;
+} ;
+
+class ChunkCutter : public cdc_ft::fastcdc::Chunker
+{
+    public:
+	ChunkCutter( const cdc_ft::fastcdc::Config& cfg )
+	    : cdc_ft::fastcdc::Chunker( cfg ) {}
+
+    private:
+	virtual void HandleOneChunk( const uint8_t*, size_t ) {}
+} ;
+
+size_t
+ChunkMap::CreateParallel( FileSys* in, Error* e, MD5* md5,
+	int threads, BLAKE3& b3 )
+{
+	const cdc_ft::fastcdc::Config cdc_cfg( cdc_min_size, cdc_avg_size,
+	                                       cdc_max_size );
+	ChunkCutter cutter( cdc_cfg );
+
+	// One batch, plus a partial chunk carried over.
+
+	const size_t cap = threads * parallelSegment + cdc_max_size;
+	StrBuf in_buf;
+	in_buf.BlockAlloc( cap );
+	const uint8_t* data = (const uint8_t*)in_buf.Text();
+
+	size_t have = 0;
+	bool eof = false;
+	size_t nChunks = 0;
+
+	std::vector< ChunkSegment > segs( threads );
+	StrBuf out_buf;
+
+	// Append one chunk's size/hash pair.
+
+	auto emit = [&]( size_t len, const uint8_t* digest )
+	    {
+	        const chunkSize_t sz = (chunkSize_t)len;
+	        out_buf.Append( (const char*)&sz, sizeof( chunkSize_t ) );
+	        out_buf.Append( (const char*)digest, BLAKE3_BUFFLEN );
+	        nChunks++;
+	    };
+
+	// Chunk a segment from its start, on its own thread.
+
+	auto work = [&]( ChunkSegment& s )
+	    {
+	        ChunkCutter c( cdc_cfg );
+	        size_t p = s.start;
+
+	        s.sizes.clear();
+	        s.digests.clear();
+
+	        while( p < s.end && ( eof || have - p >= cdc_max_size ) )
+	        {
+	            const size_t len = c.NextChunkSize( data + p, have - p );
+	            const size_t d = s.digests.size();
+
+	            s.digests.resize( d + BLAKE3_BUFFLEN );
+	            BLAKE3::Digest( (const char*)data + p, len,
+	                            &s.digests[ d ] );
+	            s.sizes.push_back( (uint32_t)len );
+	            p += len;
+	        }
+
+	        s.stop = p;
+	    };
+
+	while( !e->Test() )
+	{
+	    // Fill the batch.
+
+	    while( !eof && have < cap )
+	    {
+	        const size_t want = cap - have < 0x40000000 ? cap - have : 0x40000000;
+	        const int n = in->Read( in_buf.Text() + have, (int)want, e );
+
+	        if( e->Test() )
+	            return nChunks;
+
+	        if( n <= 0 )
+	            eof = true;
+	        else
+	            have += n;
+	    }
+
+	    if( !have )
+	        break;
+
+	    // Split it among the threads; the calling thread is worker 0.
+
+	    size_t per = ( have + threads - 1 ) / threads;
+	    if( per < 4 * cdc_max_size )
+	        per = 4 * cdc_max_size;
+
+	    int nSegs = 0;
+	    for( size_t p = 0; p < have; p += per )
+	    {
+	        segs[ nSegs ].start = p;
+	        segs[ nSegs ].end = p + per < have ? p + per : have;
+	        nSegs++;
+	    }
+
+	    std::vector< std::thread > ts;
+	    for( int i = 1; i < nSegs; i++ )
+	        ts.emplace_back( work, std::ref( segs[ i ] ) );
+
+	    work( segs[ 0 ] );
+
+	    for( size_t i = 0; i < ts.size(); i++ )
+	        ts[ i ].join();
+
+	    // Stitch the segments together at the real cut points.
+
+	    size_t p = 0;
+	    bool stuck = false;
+	    uint8_t digest[ BLAKE3_BUFFLEN ];
+
+	    for( int k = 0; k < nSegs && !stuck; k++ )
+	    {
+	        ChunkSegment& s = segs[ k ];
+	        size_t off = s.start;
+	        size_t j = 0;
+
+	        for( ;; )
+	        {
+	            while( j < s.sizes.size() && off < p )
+	                off += s.sizes[ j++ ];
+
+	            if( off == p && j < s.sizes.size() )
+	            {
+	                for( ; j < s.sizes.size(); j++ )
+	                    emit( s.sizes[ j ], &s.digests[ j * BLAKE3_BUFFLEN ] );
+	                p = s.stop;
+	                break;
+	            }
+
+	            if( p >= s.end )
+	                break;
+
+	            if( !eof && have - p < cdc_max_size )
+	            {
+	                stuck = true;
+	                break;
+	            }
+
+	            const size_t len = cutter.NextChunkSize( data + p, have - p );
+	            BLAKE3::Digest( (const char*)data + p, len, digest );
+	            emit( len, digest );
+	            p += len;
+	        }
+	    }
+
+	    // Hand on the chunks and the data they cover.
+
+	    if( md5 )
+	        md5->Update( data, p );
+
+	    ((StrBuf*)mapBuf)->Append( &out_buf );
+	    b3.Update( out_buf.Text(), out_buf.Length() );
+	    out_buf.Clear();
+
+	    // Carry over the rest, unless at EOF, when it's all chunked.
+
+	    memmove( in_buf.Text(), in_buf.Text() + p, have - p );
+	    have -= p;
+
+	    if( eof )
+	        break;
+	}
+
+	return nChunks;
 }
 
 void
@@ -103,7 +103,9 @@ class ChunkMap
 
 	    // Chunk the given file and populate the class's in-memory data.
 	    // Also optionally calculate the MD5 of the file, if we're feeling
-	    // like dragging our feet during this operation.
+	    // like dragging our feet during this operation.  Large files are
+	    // chunked on net.delta.transfer.threads threads, giving the same
+	    // map as chunking serially.
 	    void Create( const StrPtr* fromFile, Error* e );
 	    void Create( FileSys* fs, Error* e, MD5* md5 = nullptr );
 
@@ -181,6 +183,12 @@ class ChunkMap
 	        return sizeof( mapVersion_t ) + BLAKE3_BUFFLEN;
 	    }
 
+	    // The chunks of 'in', appended to mapBuf and b3, on one thread
+	    // or several.  Both return the number of chunks.
+	    size_t CreateSerial( FileSys* in, Error* e, MD5* md5, BLAKE3& b3 );
+	    size_t CreateParallel( FileSys* in, Error* e, MD5* md5,
+	                           int threads, BLAKE3& b3 );
+
 	    void SetBuf( StrPtr* map, Error* e );
 	    void CopyBuf( StrPtr* map, Error* e );
 
@@ -194,6 +202,9 @@ class ChunkMap
 	    // Get the hash of the whole chunk map file.
 	    const uint8_t *GetVerifyHash() const;
 
+	    // Size of a segment chunked by one thread in CreateParallel().
+	    static const size_t parallelSegment;
+
 	    // Version of the format of this chunk map data.
 	    mapVersion_t version = 0;
 
@@ -153,6 +153,14 @@ class ChunkerTmpl {
   // Returns the threshold for the hash <= threshold chunk boundary.
   T Threshold() { return threshold_; }
 
+  // P4 Customisation: the size of the chunk starting at 'data', where 'len'
+  // bytes are available.  Unless that's the end of the input, 'len' must be
+  // at least max_size, as Process() ensures.  The result depends only on
+  // the data, so chunking can resume at any known cut point.
+  size_t NextChunkSize(const uint8_t* data, size_t len) {
+    return FindChunkBoundary(data, len);
+  }
+
  private:
   size_t FindChunkBoundary(const uint8_t* data, size_t len) {
     if (len <= cfg_.min_size) {
@@ -14,6 +14,7 @@
 # include <vararray.h>
 # include <vartree.h>
 # include <debug.h>
+# include <charman.h>
 
 # include <pathsys.h>
 # include <filesys.h>
@@ -22,7 +23,13 @@
 
 # include "ignore.h"
 
-#include "maphalf.h"
+# include "mapchar.h"
+# include "maphalf.h"
+
+# include <string>
+# include <vector>
+# include <algorithm>
+# include <unordered_map>
 
 # ifdef OS_NT
 # define SLASH "\\"
@@ -186,6 +193,245 @@ IgnoreTable::PutItem( const StrRef &file, Error *e )
 }
 
 
+/*
+ * IgnoreMatcher -- compiled form of an ignoreList
+ *
+ * RejectCheck() used to try every rule in the list against every path.
+ * Nearly all rules generated by Insert() carry a literal that any
+ * matching path must contain: either a literal tail ("....o" must end
+ * in ".o") or a literal directory component before a trailing wildcard
+ * (".../build/..." must contain a "build/" component).  The matcher
+ * indexes rules by that literal so a path only needs to be tried
+ * against the few rules that can possibly match it, in list order.
+ * Rules without a usable literal are always tried.
+ *
+ * The #FILE and #LINE markers are resolved once, at compile time.
+ */
+
+class IgnoreMatcher {
+
+    public:
+	struct Rule {
+	    IgnoreMap	*map;
+	    const char	*file;
+	    const char	*line;
+	} ;
+
+			IgnoreMatcher( IgnorePtrArray *list );
+
+	int		Stale() const
+			{ return caseUse != StrPtr::CaseUsage(); }
+
+	void		Candidates( const StrPtr &cpath, int isDir,
+			            std::vector<int> &cands );
+
+	const Rule &	GetRule( int i ) const { return rules[ i ]; }
+
+    private:
+	typedef std::unordered_multimap< std::string, int > KeyMap;
+
+	void		Fold( std::string &k ) const;
+	void		Add( KeyMap &keys, std::vector<int> *lens,
+			     const char *k, int len, int rule );
+	void		Lookup( const KeyMap &keys, const char *k, int len,
+			        std::vector<int> &cands );
+
+	std::vector<Rule> rules;
+
+	KeyMap		tails;		// literal tail -> rules
+	std::vector<int> tailLens;	// distinct tail lengths
+	KeyMap		comps;		// whole dir component -> rules
+	KeyMap		compTails;	// dir component tail -> rules
+	std::vector<int> compTailLens;	// distinct component tail lengths
+	std::vector<int> always;	// rules with no usable literal
+	std::vector<int> excludes;	// !rules, checked both ways for dirs
+
+	StrPtr::CaseUse	caseUse;
+	std::string	key;		// lookup scratch
+} ;
+
+IgnoreMatcher::IgnoreMatcher( IgnorePtrArray *list )
+{
+	const char *ignoreFile = 0;
+	const char *ignoreLine = 0;
+
+	caseUse = StrPtr::CaseUsage();
+
+	for( int i = 0; i < list->Count(); ++i )
+	{
+	    IgnoreMap *m = list->GetItem( i );
+	    char *p = m->h.Text();
+
+	    if( !strncmp( p, "#FILE ", 6 ) )
+	    {
+	        ignoreFile = p+6;
+	        continue;
+	    }
+
+	    if( !strncmp( p, "#LINE ", 6 ) )
+	    {
+	        ignoreLine = p+6;
+	        continue;
+	    }
+
+	    int r = rules.size();
+	    Rule rule = { m, ignoreFile, ignoreLine };
+	    rules.push_back( rule );
+
+	    if( m->exclude )
+	        excludes.push_back( r );
+
+	    // Lex the pattern the way MapHalf does, remembering the
+	    // literal tail after the last wildcard and the literal run
+	    // that precedes it.
+
+	    MapChar mc;
+	    int nStars = 0, nDots = 0;
+	    int wild = 0;
+	    char *lit = p;
+	    char *segStart = p;
+	    char *segEnd = p;
+
+	    for( ;; )
+	    {
+	        char *at = p;
+	        if( !mc.Set( p, nStars, nDots ) )
+	            break;
+	        if( mc.IsWild() )
+	        {
+	            wild = 1;
+	            segStart = lit;
+	            segEnd = at;
+	            lit = p;
+	        }
+	    }
+
+	    // Literal tail: the path must end with it.  A pattern with
+	    // no wildcards at all is one long tail.
+
+	    if( p > lit )
+	    {
+	        Add( tails, &tailLens, lit, p - lit, r );
+	        continue;
+	    }
+
+	    // Trailing wildcard: if the run before it ends in a slash,
+	    // its last component must appear in the path followed by
+	    // a slash; whole if the run has a slash before it too.
+
+	    int segLen = segEnd - segStart;
+
+	    if( wild && segLen > 1 && segEnd[-1] == '/' )
+	    {
+	        const char *c = segEnd - 1;
+	        while( c > segStart && c[-1] != '/' )
+	            --c;
+
+	        int compLen = segEnd - 1 - c;
+
+	        if( compLen && c > segStart )
+	        {
+	            Add( comps, 0, c, compLen, r );
+	            continue;
+	        }
+	        else if( compLen )
+	        {
+	            Add( compTails, &compTailLens, c, compLen, r );
+	            continue;
+	        }
+	    }
+
+	    always.push_back( r );
+	}
+
+	std::sort( tailLens.begin(), tailLens.end() );
+	std::sort( compTailLens.begin(), compTailLens.end() );
+}
+
+void
+IgnoreMatcher::Fold( std::string &k ) const
+{
+	// Only ST_WINDOWS makes MapHalf::Match() ignore case.
+
+	if( caseUse == StrPtr::ST_WINDOWS )
+	    for( size_t i = 0; i < k.size(); ++i )
+	        k[i] = tolowerq( k[i] );
+}
+
+void
+IgnoreMatcher::Add( KeyMap &keys, std::vector<int> *lens,
+	const char *k, int len, int rule )
+{
+	std::string s( k, len );
+	Fold( s );
+	keys.insert( KeyMap::value_type( s, rule ) );
+
+	if( lens && std::find( lens->begin(), lens->end(), len ) == lens->end() )
+	    lens->push_back( len );
+}
+
+void
+IgnoreMatcher::Lookup( const KeyMap &keys, const char *k, int len,
+	std::vector<int> &cands )
+{
+	if( keys.empty() )
+	    return;
+
+	key.assign( k, len );
+	Fold( key );
+
+	std::pair< KeyMap::const_iterator, KeyMap::const_iterator > range =
+	    keys.equal_range( key );
+
+	for( KeyMap::const_iterator i = range.first; i != range.second; ++i )
+	    cands.push_back( i->second );
+}
+
+void
+IgnoreMatcher::Candidates( const StrPtr &cpath, int isDir,
+	std::vector<int> &cands )
+{
+	const char *path = cpath.Text();
+	int plen = cpath.Length();
+
+	cands.assign( always.begin(), always.end() );
+
+	// A !rule may keep files below a directory it doesn't match,
+	// so directories are always tried against them.
+
+	if( isDir )
+	    cands.insert( cands.end(), excludes.begin(), excludes.end() );
+
+	for( size_t i = 0; i < tailLens.size() && tailLens[i] <= plen; ++i )
+	    Lookup( tails, path + plen - tailLens[i], tailLens[i], cands );
+
+	// Every component that is followed by a slash
+
+	if( !comps.empty() || !compTails.empty() )
+	{
+	    const char *c = path;
+	    const char *s;
+
+	    while( ( s = strchr( c, '/' ) ) )
+	    {
+	        int len = s - c;
+
+	        if( len )
+	            Lookup( comps, c, len, cands );
+
+	        for( size_t i = 0; 
+	             i < compTailLens.size() && compTailLens[i] <= len; ++i )
+	            Lookup( compTails, s - compTailLens[i], compTailLens[i],
+	                    cands );
+
+	        c = s + 1;
+	    }
+	}
+
+	std::sort( cands.begin(), cands.end() );
+	cands.erase( std::unique( cands.begin(), cands.end() ), cands.end() );
+}
+
 /*
  * Ignore
  *
@@ -198,12 +444,14 @@ Ignore::Ignore()
 	ignoreTable = new IgnoreTable;
 	ignoreFiles = new StrArray;
 	ignoreList = 0;
+	matcher = 0;
 	relatives = 0;
 	defaultList = 0;
 }
 
 Ignore::~Ignore()
 {
+	delete matcher;
 	delete ignoreList;
 	delete ignoreTable;
 	delete ignoreFiles;
@@ -289,6 +537,7 @@ Ignore::Build( const StrPtr &path,
 	if( ( !configName && !this->configName.Length() ) ||
 	    ( configName && this->configName != configName ) )
 	{
+	    ResetMatcher();
 	    delete ignoreList;
 	    ignoreList = 0;
 	    delete defaultList;
@@ -308,7 +557,10 @@ Ignore::Build( const StrPtr &path,
 	        ignoreList = new IgnorePtrArray;
 
 	    if( !ignoreList->Count() )
+	    {
+	        ResetMatcher();
 	        InsertDefaults( ignoreList );
+	    }
 
 	    return 1;
 	}
@@ -516,6 +768,7 @@ Ignore::Build( const StrPtr &path,
 	            ignoreList ? "re" : "", found + foundStatic,
 	            newList.Count(), p->Text() );
 
+	    ResetMatcher();
 	    delete ignoreList;
 	    ignoreList = new IgnorePtrArray;
 
@@ -787,9 +1040,6 @@ Ignore::ParseFile( FileSys *f, const char *cwd, IgnoreArray *list )
 int
 Ignore::RejectCheck( const StrPtr &path, int isDir, StrBuf *line )
 {
-	char *ignoreFile = 0;
-	char *ignoreLine = 0;
-
 	// Fix the path separators
 
 	StrBuf cpath( path );
@@ -800,33 +1050,26 @@ Ignore::RejectCheck( const StrPtr &path, int isDir, StrBuf *line )
 	if( isDir && !cpath.EndsWith( "/", 1 ) )
 	    cpath << "/";
 
+	if( matcher && matcher->Stale() )
+	    ResetMatcher();
+
+	if( !matcher )
+	    matcher = new IgnoreMatcher( ignoreList );
+
+	std::vector<int> cands;
+	matcher->Candidates( cpath, isDir, cands );
+
 	// Dirs have /... tails when checking in reverse
 
 	MapTable dmap;
-	if( isDir )
-	{
-	    StrBuf dpath( cpath );
-	    dpath << "...";
-	    dmap.Insert( dpath );
-	}
+	int dmapBuilt = 0;
 
-	for( int i = 0; i < ignoreList->Count(); ++i )
+	for( size_t i = 0; i < cands.size(); ++i )
 	{
-	    IgnoreMap *m = ignoreList->GetItem( i );
+	    const IgnoreMatcher::Rule &r = matcher->GetRule( cands[i] );
+	    IgnoreMap *m = r.map;
 	    char *p = m->h.Text();
 
-	    if( !strncmp( p, "#FILE ", 6 ) )
-	    {
-	        ignoreFile = p+6;
-	        continue;
-	    }
-
-	    if( !strncmp( p, "#LINE ", 6 ) )
-	    {
-	        ignoreLine = p+6;
-	        continue;
-	    }
-
 	    int doAdd = m->exclude;
 
 	    // If we're checking against a directory and this is a reverse
@@ -835,23 +1078,37 @@ Ignore::RejectCheck( const StrPtr &path, int isDir, StrBuf *line )
 	    // both ways check match in either direction)
 
 	    MapParams params;
-	    if( m->h.Match( cpath, params ) ||
-	        ( isDir && doAdd && dmap.JoinCheck( LHS, m->h ) ) )
+	    int matched = m->h.Match( cpath, params );
+
+	    if( !matched && isDir && doAdd )
+	    {
+	        if( !dmapBuilt )
+	        {
+	            StrBuf dpath( cpath );
+	            dpath << "...";
+	            dmap.Insert( dpath );
+	            dmapBuilt = 1;
+	        }
+
+	        matched = dmap.JoinCheck( LHS, m->h );
+	    }
+
+	    if( matched )
 	    {
 	        if( DEBUG_MATCH )
 	            p4debug.printf(
 	                "\n\t%s[%s]\n\tmatch[%s%s]%s\n\tignore[%s]\n\n",
 	                isDir ? "dir" : "file", path.Text(), doAdd ? "+" : "-",
-	                p, doAdd ? "KEEP" : "REJECT", ignoreFile );
+	                p, doAdd ? "KEEP" : "REJECT", r.file );
 
 	        // If an ignoreLine pointer was passed, populate it with the
 	         // ignoreFile, line number and rule that we matched.
 
-	         if( line && ignoreFile && ignoreLine )
+	         if( line && r.file && r.line )
 	         {
-	             line->Set( ignoreFile );
+	             line->Set( r.file );
 	             line->UAppend( ":" );
-	             line->UAppend( ignoreLine );
+	             line->UAppend( r.line );
 	         }
 
 	        return doAdd ? 0 : 1;
@@ -866,6 +1123,12 @@ Ignore::RejectCheck( const StrPtr &path, int isDir, StrBuf *line )
 	return 0;
 }
 
+void
+Ignore::ResetMatcher()
+{
+	delete matcher;
+	matcher = 0;
+}
 
 void
 Ignore::BuildIgnoreFiles( const StrPtr &ignoreNames )
@@ -13,6 +13,7 @@ class IgnoreTable;
 class IgnoreItem;
 class IgnorePtrArray;
 class IgnoreArray;
+class IgnoreMatcher;
 class StrArray;
 class FileSys;
 
@@ -47,9 +48,12 @@ class Ignore {
 
 	int		ParseFile( FileSys *f, const char *cwd,
 			           IgnoreArray *list );
+
+	void		ResetMatcher();
 	
 	IgnoreTable	*ignoreTable;
 	IgnorePtrArray	*ignoreList;
+	IgnoreMatcher	*matcher;
 	IgnoreArray	*defaultList;
 	StrBuf		dirDepth;
 	StrBuf		foundDepth;
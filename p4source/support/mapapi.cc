@@ -18,12 +18,20 @@ MapApi::MapApi(void)
 MapApi::~MapApi(void)
 {
 	delete table;
+	delete view;
 }
 
 MapApi::MapApi( MapTable* t )
 {
 	Init();
 	table = t;
+
+	//A joined mapping is keyed by the rows it came out with.
+	for( MapItem *m = table->Get( 0 ); m; m = m->Next() )
+	{
+	    AddView( *table->GetStr( m, LHS ), *table->GetStr( m, RHS ),
+	             table->GetFlag( m ) );
+	}
 }
 
 int MapApi::Count()
@@ -74,6 +82,7 @@ MapType MapApi::GetType( int i )
 void MapApi::Clear()
 {
 	table->Clear();
+	view->Clear();
 	ambiguous = 0;
 }
 
@@ -103,6 +112,7 @@ void MapApi::Insert( const StrPtr& l, const StrPtr& r, MapType t )
 	}
 
 	table->Insert( l, r, f );
+	AddView( l, r, f );
 
 	ambiguous = 1;
 }
@@ -124,6 +134,16 @@ int MapApi::Translate( const StrPtr& from, StrBuf& to, MapDir d )
 		return 0;
 }
 
+int MapApi::TranslateMany( const StrPtr* from, int n, StrBuf& to, int* offs,
+                           MapDir d )
+{
+	MapTableT dir = ( d == MapRightLeft ? RHS : LHS );
+
+	Disambiguate();
+
+	return table->TranslateMany( dir, from, n, to, offs );
+}
+
 int MapApi::Translate( const StrPtr& from, StrArray& to, MapDir d )
 {
 	MapTableT dir = ( d == MapRightLeft ? RHS : LHS );
@@ -166,9 +186,35 @@ void MapApi::Validate( const StrPtr& path, Error* e )
 	half.Validate( 0, e );
 }
 
+int MapApi::LoadCache( const StrPtr& dir, Error* e )
+{
+	if ( !table->LoadCache( dir, *view, e ) )
+		return 0;
+
+	ambiguous = 0;
+	return 1;
+}
+
+void MapApi::SaveCache( const StrPtr& dir, Error* e )
+{
+	Disambiguate();
+	table->SaveCache( dir, *view, e );
+}
+
+void MapApi::AddView( const StrPtr& l, const StrPtr& r, int f )
+{
+	view->Append( &l );
+	view->Extend( '\0' );
+	view->Append( &r );
+	view->Extend( '\0' );
+	*view << f;
+	view->Extend( '\n' );
+}
+
 void MapApi::Init()
 {
 	ambiguous = 0;
+	view = new StrBuf;
 }
 
 void MapApi::Disambiguate()
@@ -29,6 +29,8 @@ public:
 	//Functions for doing interesting things with the mapping.
 	int Translate( const StrPtr& from, StrBuf& to, MapDir d = MapLeftRight );
 	int Translate( const StrPtr& from, StrArray& to, MapDir d = MapLeftRight );
+	int TranslateMany( const StrPtr* from, int n, StrBuf& to, int* offs,
+	                   MapDir d = MapLeftRight );
 
 	static MapApi* Join( MapApi* left, MapApi* right )
 		{ return Join( left, MapLeftRight, right, MapLeftRight ); }
@@ -36,6 +38,13 @@ public:
 
 	static void Validate( const StrPtr& path, Error* e );
 
+	//Functions for sharing the disambiguated mapping between processes,
+	//through snapshots in a cache directory, keyed by the mapping as
+	//inserted.  LoadCache() returns 0 (changing nothing) if the mapping
+	//isn't cached there, and sets e if the cached copy can't be opened.
+	int  LoadCache( const StrPtr& dir, Error* e );
+	void SaveCache( const StrPtr& dir, Error* e );
+
 private:
 	MapTable* table;
 	MapApi( MapTable* t );
@@ -43,4 +52,7 @@ private:
 
 	int ambiguous;
 	void Disambiguate();
+
+	StrBuf* view;	//the mapping as inserted, for the cache key
+	void AddView( const StrPtr& l, const StrPtr& r, int f );
 };
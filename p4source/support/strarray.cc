@@ -86,7 +86,7 @@ StrArray::StrArray( int max )
 StrArray::~StrArray()
 {
 	for( int i = 0; i < array->Count(); i++ )
-	    delete (StrBuf *)array->Get(i);
+	    delete (StrSmall *)array->Get(i);
 
 	delete array;
 }
@@ -95,7 +95,7 @@ void
 StrArray::Clear()
 {
 	for( int i = 0; i < array->Count(); i++ )
-	    delete (StrBuf *)array->Get(i);
+	    delete (StrSmall *)array->Get(i);
 	array->Clear();
 }
 
@@ -116,7 +116,7 @@ StrArray::Remove( int i )
 {
 	if( array->Get( i ) )
 	{
-	    delete Edit( i );
+	    delete (StrSmall *)Edit( i );
 	    array->Remove( i );
 	}
 }
@@ -124,7 +124,7 @@ StrArray::Remove( int i )
 StrBuf *
 StrArray::Put()
 {
-	return (StrBuf *)array->Put( new StrBuf );
+	return (StrBuf *)array->Put( new StrSmall );
 }
 
 int
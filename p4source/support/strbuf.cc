@@ -26,6 +26,8 @@
 char StrBuf::nullStrBuf[8] = "\0\0\0\0\0\0\0";
 StrRef StrRef::null( "", 0 );
 
+void (*StrBuf::allocHook)( p4size_t ) = 0;
+
 /*
  * StrPtr::CCompare/SCompare/SCompareN/SEqual
  *
@@ -609,6 +611,14 @@ StrBuf::Grow( p4size_t oldlen )
 	// we'll grow again).  But if allocating a string to begin
 	// with, add an extra byte for the null terminator that gets
 	// tacked on.
+	//
+	// A StrSmall's inline buffer is used until it is outgrown, and
+	// then left behind like an old buffer, but not deleted.
+
+	int small = !size && buffer != nullStrBuf;
+
+	if( small && length <= SIZE_STRSMALL )
+	    return;
 
 	size = length;
 
@@ -622,7 +632,8 @@ StrBuf::Grow( p4size_t oldlen )
 	    char *o = buffer;
 	    buffer = new char[ size ];
 	    memcpy( buffer, o, oldlen );
-	    delete []o;
+	    if( !small )
+		delete []o;
 	}
 	else
 	{
@@ -630,6 +641,9 @@ StrBuf::Grow( p4size_t oldlen )
 		size += 1;
 	    buffer = new char[ size ];
 	}
+
+	if( allocHook )
+	    (*allocHook)( size );
 }
 
 /*
@@ -713,6 +727,11 @@ StrBuf::UBlockAppend( const StrPtr *t )
 void
 StrBuf::Reserve( p4size_t oldlen )
 {
+	int small = !size && buffer != nullStrBuf;
+
+	if( small && length <= SIZE_STRSMALL )
+	    return;
+
 	size = length;
 
 	if( buffer != nullStrBuf )
@@ -721,12 +740,16 @@ StrBuf::Reserve( p4size_t oldlen )
 	    char *o = buffer;
 	    buffer = new char[ size ];
 	    memcpy( buffer, o, oldlen );
-	    delete []o;
+	    if( !small )
+		delete []o;
 	}
 	else
 	{
 	    buffer = new char[ size ];
 	}
+
+	if( allocHook )
+	    (*allocHook)( size );
 }
 
 void
@@ -953,11 +976,15 @@ StrBuf::Compress( StrPtr *s )
 	memcpy( newBuffer + 2, buffer + l, n );
 	newBuffer[ n + 2 ] = '\0';
 
-	delete []buffer;
+	if( size )
+	    delete []buffer;
 
 	buffer = newBuffer;
 	length = n + 2;
 	size = newSize;
+
+	if( allocHook )
+	    (*allocHook)( size );
 }
 
 void
@@ -22,6 +22,9 @@
  *
  * StrBuf is a kind-of StrPtr that allocates and extends it own buffer.
  *
+ * StrSmall is a kind-of StrBuf that holds short strings in a buffer of
+ * its own, allocating only once they outgrow it.
+ *
  * StrFixed is a kind-of StrPtr that points to a character array that
  * is fixed at construction.
  *
@@ -30,6 +33,7 @@
  *	StrPtr - a pointer/length for arbitrary data
  *	StrRef - StrPtr that can be set
  *	StrBuf - StrPtr of privately allocated data
+ *	StrSmall - StrBuf with a small inline buffer
  *	StrFixed - StrPtr to a fixed length char buffer
  *	StrNum - StrPtr that holds a string of an int
  *	StrHuman - StrPtr that holds a "human-readable" string of an int
@@ -84,6 +88,7 @@
  *	StrBuf::<< - Append contents from buffer or number
  *	StrBuf::Indent() - fill by indenting contents of another buffer
  *	StrBuf::Expand() - expand a string doing %var substitutions
+ *	StrBuf::SetAllocHook() - (static) report each buffer allocation
  *	
  */
 
@@ -99,6 +104,9 @@ class StrNum;
 # define SIZE_SMALLSTR   1024
 # define SIZE_MEDSTR     4096
 
+// StrSmall's inline buffer, including the null
+# define SIZE_STRSMALL     32
+
 class StrPtr {
 
     public:
@@ -380,7 +388,7 @@ class StrBuf : public StrPtr {
 		{ length = size = 0; buffer = nullStrBuf; }
 
 		~StrBuf()
-		{ if( buffer != nullStrBuf ) delete []buffer; }
+		{ if( size ) delete []buffer; }
 
 	// copy constructor, assignment
 
@@ -415,13 +423,20 @@ class StrBuf : public StrPtr {
 
 	void 	Reset( void )
 		{ 
-		    if( buffer != nullStrBuf ) 
+		    if( size ) 
 		    {
 	                delete []buffer; 
 		
 		        length = size = 0; 
 		        buffer = nullStrBuf; 
 		    }
+		    else if( buffer != nullStrBuf )
+		    {
+			// StrSmall keeps its inline buffer
+
+			length = 0;
+			*buffer = 0;
+		    }
 		}
 
 	void	Reset( const char *buf )
@@ -511,7 +526,7 @@ class StrBuf : public StrPtr {
 		}
 
 	p4size_t 	BufSize() const
-		{ return size; }
+		{ return size || buffer == nullStrBuf ? size : SIZE_STRSMALL; }
 
 	// leading-string compression
 
@@ -546,7 +561,18 @@ class StrBuf : public StrPtr {
 
 	StrBuf& operator <<( long unsigned int v );
 
+	// Allocation counting: if set, the hook is called with the size
+	// of each buffer StrBuf allocates.  For measuring, not for use
+	// while threads are running.
+
+	static void SetAllocHook( void (*hook)( p4size_t ) )
+		{ allocHook = hook; }
+
     private:
+
+	// size is 0 for nullStrBuf and for StrSmall's inline buffer,
+	// neither of which is ours to delete.
+
 	p4size_t	size;
 
 	void	Grow( p4size_t len );
@@ -558,6 +584,52 @@ class StrBuf : public StrPtr {
 	// enough that we aren't reaching past valid memory.  The
 	// largest one seems to be DbInt64 (8 bytes.)
 	static char nullStrBuf[ 8 ];
+
+	static void (*allocHook)( p4size_t );
+} ;
+
+/*
+ * StrSmall - a StrBuf that starts out in a buffer of its own
+ *
+ * Strings up to SIZE_STRSMALL bytes (with the null) are kept inline;
+ * longer ones move to the heap as with any StrBuf, and stay there.
+ * StrBuf tells the inline buffer by its size of 0, so StrBuf's own
+ * layout is unchanged.
+ *
+ * StrBuf's destructor isn't virtual: delete a StrSmall as a StrSmall.
+ */
+
+class StrSmall : public StrBuf {
+
+    public:
+		StrSmall()
+		{ SmallInit(); }
+
+		StrSmall( const StrSmall &s ) : StrBuf()
+		{ SmallInit(); Set( &s ); }
+
+		StrSmall( const StrPtr &s )
+		{ SmallInit(); Set( &s ); }
+
+		StrSmall( const char *buf )
+		{ SmallInit(); Set( buf ); }
+
+	// Not the default assignment, which would copy 'small' too.
+
+	const StrSmall & operator =( const StrSmall &s )
+		{ Set( &s ); return *this; }
+
+	const StrSmall & operator =( const StrPtr &s )
+		{ Set( &s ); return *this; }
+
+	const StrSmall & operator =( const char *buf )
+		{ if( (const char*)this != buf ) Set( buf ); return *this; }
+
+    private:
+	void	SmallInit()
+		{ buffer = small; *small = 0; }
+
+	char	small[ SIZE_STRSMALL ];
 } ;
 
 class StrFixed : public StrPtr {
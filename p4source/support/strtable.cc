@@ -22,8 +22,8 @@ struct StrPtrEntry {
 } ;
 
 struct StrBufEntry {
-	StrBuf	var;
-	StrBuf	val;
+	StrSmall var;
+	StrSmall val;
 
 # ifdef OS_UNIXWARE
 
@@ -115,6 +115,210 @@ StrPtrDict::VRemoveVar( const StrPtr &var )
 	}
 }
 
+/* StrPtrHashDict */
+
+/*
+ * Entries come in blocks of HashBlock; the hash index is only built
+ * once a table has more than HashLinear entries, below that a scan
+ * is cheaper.  The index is kept at most half full.
+ */
+
+const int HashBlockShift = 6;
+const int HashBlock = 1 << HashBlockShift;
+const int HashLinear = 8;
+
+# define CHARHASH( h, c ) ( 293 * (h) + (c) )
+
+struct StrHashSlot {
+	int		entry;		// -1 if empty
+	unsigned int	hash;
+} ;
+
+static unsigned int
+StrHashKey( const StrPtr &var )
+{
+	// StrPtr == is strcmp(), so hash up to the null
+
+	unsigned int h = 0;
+	for( const unsigned char *p = (const unsigned char *)var.Text(); *p; )
+	    h = CHARHASH( h, *p++ );
+	return h;
+}
+
+StrPtrHashDict::StrPtrHashDict()
+{
+	blocks = 0;
+	nBlocks = 0;
+	tabLength = 0;
+	slots = 0;
+	slotMask = -1;
+	indexed = 0;
+}
+
+StrPtrHashDict::~StrPtrHashDict()
+{
+	for( int i = 0; i < nBlocks; i++ )
+	    delete []blocks[i];
+
+	delete []blocks;
+	delete []slots;
+}
+
+inline StrPtrEntry *
+StrPtrHashDict::Entry( int x )
+{
+	return blocks[ x >> HashBlockShift ] + ( x & ( HashBlock - 1 ) );
+}
+
+void
+StrPtrHashDict::Index()
+{
+	// Grow (and rebuild from scratch) if the index would pass half full;
+	// a rebuild also starts from scratch after Clear() or RemoveVar().
+
+	if( !indexed || tabLength * 2 > slotMask + 1 )
+	{
+	    int size = slotMask + 1 ? slotMask + 1 : 64;
+
+	    while( tabLength * 2 > size )
+		size *= 2;
+
+	    if( size != slotMask + 1 )
+	    {
+		delete []slots;
+		slots = new StrHashSlot[ size ];
+		slotMask = size - 1;
+	    }
+
+	    for( int i = 0; i < size; i++ )
+		slots[i].entry = -1;
+
+	    indexed = 0;
+	}
+
+	// Add entries that came since last time.  A name already in
+	// the index keeps its earlier entry, as GetVar finds the first.
+
+	for( ; indexed < tabLength; indexed++ )
+	{
+	    StrPtrEntry *s = Entry( indexed );
+	    unsigned int h = StrHashKey( s->var );
+	    StrHashSlot *slot;
+
+	    for( int i = h & slotMask; ; i = ( i + 1 ) & slotMask )
+	    {
+		slot = &slots[i];
+
+		if( slot->entry < 0 )
+		{
+		    slot->entry = indexed;
+		    slot->hash = h;
+		    break;
+		}
+
+		if( slot->hash == h && Entry( slot->entry )->var == s->var )
+		    break;
+	    }
+	}
+}
+
+StrPtr *
+StrPtrHashDict::VGetVar( const StrPtr &var )
+{
+	if( tabLength <= HashLinear )
+	{
+	    for( int i = 0; i < tabLength; i++ )
+	    {
+		StrPtrEntry *s = Entry( i );
+
+		if( s->var == var ) 
+		    return &s->val;
+	    }
+
+	    return 0;
+	}
+
+	if( indexed < tabLength )
+	    Index();
+
+	unsigned int h = StrHashKey( var );
+
+	for( int i = h & slotMask; ; i = ( i + 1 ) & slotMask )
+	{
+	    StrHashSlot *slot = &slots[i];
+
+	    if( slot->entry < 0 )
+		return 0;
+
+	    if( slot->hash == h )
+	    {
+		StrPtrEntry *s = Entry( slot->entry );
+
+		if( s->var == var )
+		    return &s->val;
+	    }
+	}
+}
+
+int
+StrPtrHashDict::VGetVarX( int x, StrRef &var, StrRef &val )
+{
+	if( x < 0 || x >= tabLength )
+	    return 0;
+
+	StrPtrEntry *s = Entry( x );
+
+	var = s->var;
+	val = s->val;
+
+	return 1;
+}
+
+void
+StrPtrHashDict::VSetVar( const StrPtr &var, const StrPtr &val )
+{
+	// Add a block, keeping the old ones where they are
+
+	if( tabLength == nBlocks * HashBlock )
+	{
+	    StrPtrEntry **nb = new StrPtrEntry *[ nBlocks + 1 ];
+
+	    for( int i = 0; i < nBlocks; i++ )
+		nb[i] = blocks[i];
+
+	    nb[ nBlocks++ ] = new StrPtrEntry[ HashBlock ];
+
+	    delete []blocks;
+	    blocks = nb;
+	}
+
+	StrPtrEntry *s = Entry( tabLength++ );
+
+	s->var = var;
+	s->val = val;
+}
+
+void
+StrPtrHashDict::VRemoveVar( const StrPtr &var )
+{
+	for( int i = 0; i < tabLength; i++ )
+	{
+	    StrPtrEntry *s = Entry( i );
+
+	    if( s->var == var ) 
+	    {
+		// Same reordering as StrPtrDict: last entry fills the hole
+
+		StrPtrEntry t = *s;
+		*s = *Entry( --tabLength );
+		*Entry( tabLength ) = t;
+		indexed = 0;
+
+		return;
+	    }
+	}
+}
+
 /* StrBufDict */
 
 StrBufDict::StrBufDict()
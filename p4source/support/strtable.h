@@ -10,6 +10,7 @@
  * Classes defined:
  *
  *	StrPtrDict - a dictionary whose values we don't own
+ *	StrPtrHashDict - a StrPtrDict with hashed lookup, for big tables
  *	StrBufDict - a dictionary whose values we do own
  *	BufferDict - a dictionary stuffed into a StrBuf.
  *
@@ -24,6 +25,7 @@
 
 struct StrPtrEntry;
 struct StrBufEntry;
+struct StrHashSlot;
 class VarArray;
 
 class StrPtrDict : public StrDict {
@@ -49,6 +51,44 @@ class StrPtrDict : public StrDict {
 
 } ;
 
+/*
+ * StrPtrHashDict - StrPtrDict semantics (first SetVar of a name wins
+ * on GetVar, GetVar(x) in SetVar order) with an open addressing hash
+ * index once the table outgrows a short linear scan.  Entries live in
+ * fixed blocks reused across Clear(), so returned StrPtrs stay put
+ * and a refill after Clear() allocates nothing.
+ */
+
+class StrPtrHashDict : public StrDict {
+
+    public:
+			StrPtrHashDict();
+			~StrPtrHashDict();
+
+	// virtuals of StrDict
+
+	StrPtr *	VGetVar( const StrPtr &var );
+	void		VSetVar( const StrPtr &var, const StrPtr &val );
+	void		VRemoveVar( const StrPtr &var );
+	int		VGetVarX( int x, StrRef &var, StrRef &val );
+	void		VClear() { tabLength = 0; indexed = 0; }
+	int		VGetCount() { return tabLength; }
+
+    private:
+
+	StrPtrEntry *	Entry( int x );
+	void		Index();
+
+	StrPtrEntry	**blocks;
+	int		nBlocks;
+	int		tabLength;
+
+	StrHashSlot	*slots;
+	int		slotMask;	// slot count - 1
+	int		indexed;	// entries [0,indexed) are in slots
+
+} ;
+
 class StrBufDict : public StrDict {
 
     public:
@@ -24,8 +24,8 @@ struct VarVal {
 } ;
 
 struct StrArrTreeItem {
-	StrBuf var;
-	VarArray vals;  // array of StrPtr*
+	StrSmall var;
+	VarArray vals;  // array of StrSmall*
 } ;
 
 // StrArrVTree allows multiple values for each item in the tree
@@ -58,7 +58,7 @@ StrArrVTree::Delete( void *a ) const
 {
 	for( int i = 0; i < ( (StrArrTreeItem *)a )->vals.Count(); i++ )
 	{
-	    StrBuf *p = (StrBuf *)( (StrArrTreeItem *)a )->vals.Get( i );
+	    StrSmall *p = (StrSmall *)( (StrArrTreeItem *)a )->vals.Get( i );
 	    delete p;
 	}
 
@@ -182,7 +182,7 @@ StrBufTree::VSetVar( const StrPtr &var, const StrPtr &val )
 
 	if( item )
 	{
-	    StrBuf *valPtr = new StrBuf( val );
+	    StrSmall *valPtr = new StrSmall( val );
 	    ( item->vals ).Put( valPtr );
 	}
 }
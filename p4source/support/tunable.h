@@ -49,6 +49,7 @@ enum P4TunableName {
 	P4TUNE_DIFF_STHRESH,
 	P4TUNE_DM_ALTSYNC_ENFORCE,
 	P4TUNE_DM_ANNOTATE_MAXSIZE,
+	P4TUNE_DM_ANNOTATE_THREADS,		// see diffmultimulti.cc
 	P4TUNE_DM_BATCH_DOMAINS,		// see dmdomains.cc
 	P4TUNE_DM_BATCH_NET,			// see dmrprobe.cc
 	P4TUNE_DM_CHANGE_RESTRICT_PENDING,
@@ -154,6 +155,8 @@ enum P4TunableName {
 	P4TUNE_FILESYS_EXTENDLOWMARK,
 	P4TUNE_FILESYS_WINDOWS_LFN,		// see filesys.cc
 	P4TUNE_FILESYS_CLIENT_NULLSYNC,		// see clientservice.cc
+	P4TUNE_FILESYS_CLIENT_WRITEBEHIND,	// see clientwriter.cc
+	P4TUNE_FILESYS_SCAN_THREADS,		// see clienttraverse.cc
 	P4TUNE_INDEX_DOMAIN_OWNER,              // see dmdomains.cc
 	P4TUNE_LBR_AUTOCOMPRESS,		// see submit
 	P4TUNE_LBR_BUFSIZE,			// see lbr.h
@@ -175,6 +178,7 @@ enum P4TunableName {
 	P4TUNE_LBR_RCS_LOCKING,                 // see dmgrcslock.cc
 	P4TUNE_LOG_GROUP_MAXLEN,		// see rhservice.cc
 	P4TUNE_LOG_ORIGINHOST,			// see rhloggable.cc
+	P4TUNE_MAP_JOIN_THREADS,		// see mapjoin.cc
 	P4TUNE_MAP_JOINMAX1,
 	P4TUNE_MAP_JOINMAX2,
 	P4TUNE_MAP_LIMIT_MAXLOOKBACK,
@@ -183,8 +187,10 @@ enum P4TunableName {
 	P4TUNE_MERGE_DL_ENDEOL,
 	P4TUNE_NET_AUTOTUNE,
 	P4TUNE_NET_BUFSIZE,			// see netbuffer.h
+	P4TUNE_NET_COMPRESSION_CODEC,		// see rpc.cc
 	P4TUNE_NET_DELTA_TRANSFER_MINSIZE,	// see clientservice.cc/usersubmit.cc
 	P4TUNE_NET_DELTA_TRANSFER_THRESHOLD,	// see clientservice.cc
+	P4TUNE_NET_DELTA_TRANSFER_THREADS,	// see chunkmap.cc
 	P4TUNE_NET_KEEPALIVE_DISABLE,		// see nettcptransport.cc
 	P4TUNE_NET_KEEPALIVE_IDLE,		// see nettcptransport.cc
 	P4TUNE_NET_KEEPALIVE_INTERVAL,		// see nettcptransport.cc
@@ -210,6 +216,7 @@ enum P4TunableName {
 	P4TUNE_NET_PARALLEL_SUBMIT_BATCH,	// see usersubmit.cc
 	P4TUNE_NET_PARALLEL_SUBMIT_MIN,		// see usersubmit.cc
 	P4TUNE_NET_PARALLEL_SYNC_SVRTHREADS,	// see usersync.cc
+	P4TUNE_NET_PARALLEL_POOL,		// see clientrcvfiles.cc
 	P4TUNE_NET_RCVBUFLOWMARK,		// see netbuffer.cc
 	P4TUNE_NET_RCVBUFMAXSIZE,		// see netbuffer.cc
 	P4TUNE_NET_RCVBUFSIZE,			// see netbuffer.h
@@ -231,6 +238,7 @@ enum P4TunableName {
 	P4TUNE_RPC_HIMARK,
 	P4TUNE_RPC_LOWMARK,
 	P4TUNE_RPC_IPADDR_MISMATCH,		// see rhservice.cc, rpcfwd.cc
+	P4TUNE_RPC_CLIENT_ARENA,		// see client.cc
 	P4TUNE_RPL_ARCHIVE_GRAPH,		// see server / rpl.cc
 	P4TUNE_RPL_AWAITJNL_COUNT,		// See server / rmtservice.cc
 	P4TUNE_RPL_AWAITJNL_INTERVAL,		// See server / rmtservice.cc
@@ -361,6 +369,7 @@ enum P4TunableName {
 	P4TUNE_RPL_PULL_RELOAD,			// see userpull.cc
 	P4TUNE_SSL_SECONDARY_SUITE,             // see netssltransport.cc
 	P4TUNE_SSL_CLIENT_TIMEOUT,		// see netssltransport.cc
+	P4TUNE_SSL_CLIENT_SESSION_REUSE,	// see netssltransport.cc
 	P4TUNE_SSL_CLIENT_TLS_VERSION_MIN,	// see netssltransport.cc
 	P4TUNE_SSL_CLIENT_TLS_VERSION_MAX,	// see netssltransport.cc
 	P4TUNE_SSL_CLIENT_TRUST_NAME,		// see clienttrust.cc
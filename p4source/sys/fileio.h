@@ -202,6 +202,7 @@ class FileIOBuffer : public FileIOCompress {
 
 	virtual void	FlushBuffer( Error * );
 	virtual void	FillBuffer( Error * );
+	virtual int	CanWriteThrough();
 
 	void		WriteText( const char *buf, int len, Error *e );
 
@@ -229,6 +230,8 @@ class FileIOUnicode : public FileIOBuffer {
 
 	virtual void	FlushBuffer( Error * );
 	virtual void	FillBuffer( Error * );
+	virtual int	CanWriteThrough()
+			{ return !trans && FileIOBuffer::CanWriteThrough(); }
 } ;
 
 class FileIOUTF16 : public FileIOUnicode {
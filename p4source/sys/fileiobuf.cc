@@ -78,11 +78,31 @@ FileIOBuffer::Close( Error *e )
 	FileIOCompress::Close( e );
 }
 
+int
+FileIOBuffer::CanWriteThrough()
+{
+	// Only if FlushBuffer() would write iobuf out untouched.
+
+#if defined( USE_EBCDIC ) && defined( NO_EBCDIC_FILES )
+	return 0;
+#else
+	return !snd && 
+	    ( lineType == LineTypeRaw || lineType == LineTypeLfcrlf );
+#endif
+}
+
 void
 FileIOBuffer::Write( const char *buf, int len, Error *e )
 {
+	// A block at least as big as iobuf, with nothing buffered and
+	// no line ending translation, would only be copied into iobuf
+	// to be written straight back out: write it from the caller's
+	// buffer instead (e.g. the RPC buffer holding a 'data' var).
+
 	if( IsUnCompress() )
 	    FileIOCompress::Write( buf, len, e );
+	else if( len >= iobuf.Length() && CanWriteThrough() )
+	    FileIOCompress::WriteThrough( buf, len, e );
 	else
 	    WriteText( buf, len, e );
 }
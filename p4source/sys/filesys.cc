@@ -24,6 +24,7 @@
 # include <strops.h>
 # include <md5.h>
 # include <datetime.h>
+# include <arena.h>
 
 # include "pathsys.h"
 # include "filesys.h"
@@ -145,6 +146,18 @@ FileSys::Create( FileSysType t, FileSysBuffer *buf )
 	return f;
 }
 
+void *
+FileSys::operator new( size_t n )
+{
+	return Arena::Alloc( Arena::Current(), n );
+}
+
+void
+FileSys::operator delete( void *p )
+{
+	Arena::Free( p );
+}
+
 FileSys::FileSys()
 {
 	// start off with permission bits as the umask;
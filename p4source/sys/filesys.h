@@ -269,6 +269,11 @@ class FileSys {
 	// special temp for simple locking
 	static FileSys *CreateLock( FileSys *, Error * );
 
+	// allocated from the current Arena, if any (see arena.h)
+
+	static void	*operator new( size_t n );
+	static void	operator delete( void *p );
+
 	static FilePerm Perm( const char *p );
 
 	static bool     FileExists( const char *p );
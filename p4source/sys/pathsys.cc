@@ -11,6 +11,7 @@
 # include <msgsupp.h>
 # include <strbuf.h>
 # include <strops.h>
+# include <arena.h>
 
 # include "pathsys.h"
 # include "pathunix.h"
@@ -100,6 +101,18 @@ PathSys::Create( int flag )
 	}
 }
 
+void *
+PathSys::operator new( size_t n )
+{
+	return Arena::Alloc( Arena::Current(), n );
+}
+
+void
+PathSys::operator delete( void *p )
+{
+	Arena::Free( p );
+}
+
 PathSys *
 PathSys::Create()
 {
@@ -70,6 +70,11 @@ class PathSys : public StrBuf {
 # endif
 	static const char *GetOS();
 
+	// allocated from the current Arena, if any (see arena.h)
+
+	static void	*operator new( size_t n );
+	static void	operator delete( void *p );
+
     private:
 	static PathSys *Create( int os );
 } ;
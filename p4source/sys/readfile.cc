@@ -25,6 +25,8 @@
 
 # include "readfile.h"
 
+# include <new>
+
 /*
  * ReadFile standard implementation (using read/write)
  */
@@ -102,6 +104,76 @@ ReadFile::Open( FileSys *f, Error *e )
 	mend = mptr + offset;
 }
 
+void
+ReadFile::Preload( offL_t maxLen )
+{
+	// Only an unmapped file, straight after Open().
+
+	if( mapped || !fp || offset || size <= 0 || size > maxLen )
+	    return;
+
+	// size is the file's size on disk: translation can make the
+	// data we read shorter or longer, so read to EOF.
+
+	size_t len = size + 1;
+	size_t n = 0;
+	unsigned char *buf = 0;
+
+	try
+	{
+	    buf = new unsigned char[ len ];
+
+	    for( ;; )
+	    {
+		if( n == len )
+		{
+		    unsigned char *nbuf = new unsigned char[ len * 2 ];
+		    memcpy( nbuf, buf, n );
+		    delete []buf;
+		    buf = nbuf;
+		    len *= 2;
+		}
+
+		size_t want = len - n;
+		if( want > 0x40000000 )
+		    want = 0x40000000;
+
+		int l = fp->Read( (char *)buf + n, (int)want, e );
+
+		if( e->Test() || l <= 0 )
+		    break;
+
+		n += l;
+	    }
+	} catch( const std::bad_alloc & )
+	{
+	    // Too big after all: start again with the window.
+
+	    delete []buf;
+	    buf = 0;
+	}
+
+	if( !buf || e->Test() )
+	{
+	    delete []buf;
+	    e->Clear();
+	    fp->Seek( 0, e );
+	    e->Clear();
+	    mptr = mend = maddr;
+	    offset = 0;
+	    return;
+	}
+
+	// Now it's as good as mapped: maddr ... mptr ... mend
+
+	delete []maddr;
+
+	maddr = mptr = buf;
+	mlen = len;
+	mend = maddr + n;
+	offset = size = n;
+}
+
 void
 ReadFile::Close()
 {
@@ -14,6 +14,7 @@
  * Public methods:
  *
  *	ReadFile::Open() - open a file
+ *	ReadFile::Preload() - read an unmapped file wholly into memory
  *	ReadFile::Close() - close the file
  *
  *	ReadFile::Eof() - true if no more input
@@ -21,6 +22,9 @@
  * 	ReadFile::Next() - advance input character
  * 	ReadFile::Get() - combo Eof/Char/Next
  * 	ReadFile::Tell() - what is offset of current characater
+ *	ReadFile::Avail() - characters in memory at the current one
+ *	ReadFile::Ptr() - the current character in memory
+ *	ReadFile::Skip() - advance input over characters in memory
  *	ReadFile::Memcpy() - copy into buffer
  *	ReadFile::Memccpy() - copy up to marker char into buffer
  *	ReadFile::Memchr() - scan to marker char
@@ -38,9 +42,20 @@
  *	Open() takes a FileSys, which must remain valid until Close().
  *	Open()/Close() call FileSys::Open()/Close().
  *
+ *	Open() mmaps the file if it can (raw files up to filesys.maxmap),
+ *	else reads through a window and Seek() outside the window goes
+ *	back to the file.  Preload(), right after Open(), reads such a
+ *	file (e.g. one with line ending or charset translation) wholly
+ *	into memory if its size is within the limit given, so Seek() is
+ *	always within memory.  It leaves the window as is on failure.
+ *
  *	Char() is not valid for a character until Eof() has been called
  *	first to make sure you're not at EOF.
  *
+ *	Avail() is like Eof(), refilling the window if it is empty, but
+ *	returns the number of characters at Ptr(); Skip() may then move
+ *	over up to that many, e.g. to hash a run of characters in bulk.
+ *
  *	Textcpy() consumes the minimum of srclen and dstlen, returning
  *	the actual dstlen.  The actual srclen can be discerned by bracketing
  *	with Offset() calls.
@@ -67,6 +82,7 @@ class ReadFile
 			~ReadFile();
 
 	void		Open( FileSys *f, Error *e );
+	void		Preload( offL_t maxLen );
 	void		Close();
 
 	int		Char() { return *mptr; }
@@ -78,6 +94,10 @@ class ReadFile
 	offL_t		Tell() { return offset - ( mend - mptr ); }
 	int		Eof() { return !InMem(); }
 
+	int		Avail() { return InMem(); }
+	const unsigned char *Ptr() { return mptr; }
+	void		Skip( int n ) { mptr += n; }
+
 	void		Seek( offL_t p );
 
 	offL_t		Memcmp( ReadFile *other, offL_t length );